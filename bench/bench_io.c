@@ -0,0 +1,95 @@
+#include "../src/lab.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+
+/**
+ * @file bench_io.c
+ * @brief Throughput of list_save(), list_load() and list_map_file() for int
+ * and string lists.
+ * Usage: bench_io [n] [path]
+ */
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void report(const char *what, const char *path, double seconds) {
+    struct stat st;
+    double bytes = stat(path, &st) == 0 ? (double)st.st_size : 0.0;
+    printf("%-16s %10.1f MB %9.3f s %9.2f GB/s\n",
+           what, bytes / 1e6, seconds, bytes / seconds / 1e9);
+}
+
+static void bench_codec(const char *name, List *list, const ListCodec *codec, const char *path) {
+    char label[32];
+
+    double start = now_seconds();
+    if (!list_save(list, path, codec)) {
+        fprintf(stderr, "save failed\n");
+        exit(EXIT_FAILURE);
+    }
+    snprintf(label, sizeof(label), "save %s", name);
+    report(label, path, now_seconds() - start);
+
+    start = now_seconds();
+    List *back = list_load(path, codec);
+    if (!back || list_size(back) != list_size(list)) {
+        fprintf(stderr, "load failed\n");
+        exit(EXIT_FAILURE);
+    }
+    snprintf(label, sizeof(label), "load %s", name);
+    report(label, path, now_seconds() - start);
+    list_destroy(back, free);
+
+    // Mapping only reads the header; the scan touches every element
+    start = now_seconds();
+    List *mapped = list_map_file(path, codec);
+    double map_seconds = now_seconds() - start;
+    if (!mapped) {
+        fprintf(stderr, "map failed\n");
+        exit(EXIT_FAILURE);
+    }
+    ListIter it = list_iter(mapped);
+    void *elem;
+    size_t touched = 0;
+    while (list_next(&it, &elem)) {
+        touched += *(const unsigned char *)elem;
+    }
+    snprintf(label, sizeof(label), "map+scan %s", name);
+    report(label, path, now_seconds() - start);
+    printf("%-16s %10.1f us (checksum %zu)\n", "  map only", map_seconds * 1e6, touched);
+    list_destroy(mapped, NULL);
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? (size_t)atol(argv[1]) : 10000000;
+    const char *path = argc > 2 ? argv[2] : "/tmp/bench_io.bin";
+
+    List *ints = list_create(LIST_LINKED_SENTINEL);
+    List *strs = list_create(LIST_LINKED_SENTINEL);
+    for (size_t i = 0; i < n; i++) {
+        int *val = malloc(sizeof(int));
+        *val = rand();
+        list_append(ints, val);
+
+        size_t len = 16 + (size_t)rand() % 48;
+        char *s = malloc(len + 1);
+        for (size_t j = 0; j < len; j++) {
+            s[j] = (char)('a' + rand() % 26);
+        }
+        s[len] = '\0';
+        list_append(strs, s);
+    }
+
+    bench_codec("int", ints, &LIST_CODEC_INT, path);
+    bench_codec("string", strs, &LIST_CODEC_STR, path);
+
+    remove(path);
+    list_destroy(strs, free);
+    list_destroy(ints, free);
+    return EXIT_SUCCESS;
+}
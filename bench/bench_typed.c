@@ -0,0 +1,118 @@
+#include "../src/lab.h"
+#include "../src/lab_typed.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * @file bench_typed.c
+ * @brief A LIST_DEFINE int list against the generic list on the same ints,
+ * once with boxed elements (a malloc per int) and once with inline values.
+ * Every variant sorts in compare_int order (descending).
+ * Usage: bench_typed [n]
+ */
+
+LIST_DEFINE(intlist, int, (a) > (b))
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void report(const char *variant, const char *what, double seconds, size_t n) {
+    printf("%-16s %-10s %9.1f ms %7.1f ns/elem\n", variant, what, seconds * 1e3, seconds * 1e9 / (double)n);
+}
+
+static void check(bool ok, const char *what) {
+    if (!ok) {
+        fprintf(stderr, "%s failed\n", what);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void bench_generic(const char *variant, const int *values, size_t n, bool boxed) {
+    double start = now_seconds();
+    List *list = boxed ? list_create(LIST_LINKED_SENTINEL) : list_create_inline(sizeof(int));
+    check(list != NULL, "create");
+    for (size_t i = 0; i < n; i++) {
+        int *val = (int *)&values[i];
+        if (boxed) {
+            val = malloc(sizeof(int));
+            *val = values[i];
+        }
+        check(list_append(list, val), "append");
+    }
+    report(variant, "append", now_seconds() - start, n);
+
+    start = now_seconds();
+    sort(list, 0, n - 1, compare_int);
+    report(variant, "sort", now_seconds() - start, n);
+
+    start = now_seconds();
+    check(is_sorted(list, compare_int), "is_sorted");
+    report(variant, "is_sorted", now_seconds() - start, n);
+
+    start = now_seconds();
+    long long sum = 0;
+    ListIter it = list_iter(list);
+    void *elem;
+    while (list_next(&it, &elem)) {
+        sum += *(const int *)elem;
+    }
+    report(variant, "scan", now_seconds() - start, n);
+
+    start = now_seconds();
+    list_destroy(list, boxed ? free : NULL);
+    report(variant, "destroy", now_seconds() - start, n);
+    printf("%-16s checksum %lld\n", variant, sum);
+}
+
+static void bench_typed(const int *values, size_t n) {
+    const char *variant = "typed";
+    double start = now_seconds();
+    intlist *list = intlist_create();
+    check(list != NULL, "create");
+    for (size_t i = 0; i < n; i++) {
+        check(intlist_append(list, values[i]), "append");
+    }
+    report(variant, "append", now_seconds() - start, n);
+
+    start = now_seconds();
+    check(intlist_sort(list), "sort");
+    report(variant, "sort", now_seconds() - start, n);
+
+    start = now_seconds();
+    check(intlist_is_sorted(list), "is_sorted");
+    report(variant, "is_sorted", now_seconds() - start, n);
+
+    start = now_seconds();
+    long long sum = 0;
+    for (intlist_node *node = intlist_begin(list); node != intlist_end(list); node = node->next) {
+        sum += node->value;
+    }
+    report(variant, "scan", now_seconds() - start, n);
+
+    start = now_seconds();
+    intlist_destroy(list);
+    report(variant, "destroy", now_seconds() - start, n);
+    printf("%-16s checksum %lld\n", variant, sum);
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? (size_t)atol(argv[1]) : 10000000;
+    if (n < 2) n = 2;
+
+    int *values = malloc(sizeof(int) * n);
+    check(values != NULL, "allocation");
+    for (size_t i = 0; i < n; i++) {
+        values[i] = rand();
+    }
+
+    bench_generic("generic boxed", values, n, true);
+    bench_generic("generic inline", values, n, false);
+    bench_typed(values, n);
+
+    free(values);
+    return EXIT_SUCCESS;
+}
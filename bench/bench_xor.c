@@ -0,0 +1,96 @@
+#include "../src/lab.h"
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * @file bench_xor.c
+ * @brief Heap bytes per element and append/scan/sort/merge times of
+ * LIST_XOR against LIST_LINKED_SENTINEL (and LIST_COMPACT) on the same ints.
+ * Elements point into one shared array, so only the list's own memory is
+ * counted, as reported by the allocator (glibc mallinfo2()).
+ * Usage: bench_xor [n]
+ */
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static size_t heap_in_use(void) {
+    // Large blocks are mmapped and counted apart from the heap proper
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+static void report(const char *variant, const char *what, double seconds, size_t n) {
+    printf("%-8s %-10s %9.1f ms %7.1f ns/elem\n", variant, what, seconds * 1e3, seconds * 1e9 / (double)n);
+}
+
+static void check(bool ok, const char *what) {
+    if (!ok) {
+        fprintf(stderr, "%s failed\n", what);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void bench_type(const char *variant, ListType type, int *values, size_t n) {
+    size_t heap_before = heap_in_use();
+    double start = now_seconds();
+    List *list = list_create(type);
+    check(list != NULL, "create");
+    for (size_t i = 0; i < n; i++) {
+        check(list_append(list, &values[i]), "append");
+    }
+    report(variant, "append", now_seconds() - start, n);
+    size_t bytes = heap_in_use() - heap_before;
+
+    start = now_seconds();
+    long long sum = 0;
+    ListIter it = list_iter(list);
+    void *elem;
+    while (list_next(&it, &elem)) {
+        sum += *(const int *)elem;
+    }
+    report(variant, "scan", now_seconds() - start, n);
+
+    start = now_seconds();
+    while (list_prev(&it, &elem)) {
+        sum -= *(const int *)elem;
+    }
+    report(variant, "scan back", now_seconds() - start, n);
+
+    start = now_seconds();
+    sort(list, 0, n - 1, compare_int);
+    report(variant, "sort", now_seconds() - start, n);
+    check(is_sorted(list, compare_int), "is_sorted");
+
+    start = now_seconds();
+    List *merged = merge(list, list, compare_int);
+    check(merged != NULL && list_size(merged) == 2 * n, "merge");
+    report(variant, "merge", now_seconds() - start, 2 * n);
+
+    printf("%-8s %-10s %9.1f bytes/elem (checksum %lld)\n", variant, "memory", (double)bytes / (double)n, sum);
+    list_destroy(merged, NULL);
+    list_destroy(list, NULL);
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? (size_t)atol(argv[1]) : 10000000;
+    if (n < 2) n = 2;
+
+    int *values = malloc(sizeof(int) * n);
+    check(values != NULL, "allocation");
+    for (size_t i = 0; i < n; i++) {
+        values[i] = rand();
+    }
+
+    bench_type("linked", LIST_LINKED_SENTINEL, values, n);
+    bench_type("compact", LIST_COMPACT, values, n);
+    bench_type("xor", LIST_XOR, values, n);
+
+    free(values);
+    return EXIT_SUCCESS;
+}
@@ -1,29 +1,10 @@
-#include "lab.h"
+#include "lab_internal.h"
+#include "lab_sort.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
 
-/**
- * @brief structure for the doubly linked list
- * AI Use: No AI
- */
-typedef struct Node {
-    void *data;
-    struct Node *next;
-    struct Node *prev;
-} Node;
-
-/**
- * @brief structure containing the sentinel node and metadata
- * AI Use: No AI
- */
-struct List {
-    Node *sentinel;
-    size_t size;
-    ListType type;
-};
-
 /**
  * @brief Create a new node with the given data
  * @param data Pointer to the data to store in the node
@@ -48,7 +29,7 @@ static Node *node_create(void *data) {
  * AI Use: Assisted AI
  */
 List *list_create(ListType type) {
-    if (type != LIST_LINKED_SENTINEL) {
+    if (type != LIST_LINKED_SENTINEL && type != LIST_COMPACT && type != LIST_XOR) {
         return NULL; 
     }
     
@@ -69,10 +50,65 @@ List *list_create(ListType type) {
     
     list->size = 0;
     list->type = type;
+    list->pool = (NodePool){ .stride = sizeof(Node) };
+    list->sort_opts = SORT_OPTIONS_DEFAULT;
+    list->scratch = NULL;
+    list->scratch_bytes = 0;
+    list->map = (MappedView){ 0 };
+    list->arena = NULL;
+    list->value_size = 0;
+    list->compact = (CompactPool){ 0 };
+    if (type == LIST_COMPACT && !lab_compact_init(&list->compact)) {
+        free(list->sentinel);
+        free(list);
+        return NULL;
+    }
+    list->xor_pool = (XorPool){ 0 };
+    if (type == LIST_XOR) {
+        lab_xor_init(&list->xor_pool);
+    }
     
     return list;
 }
 
+/**
+ * @brief Create a list whose nodes store values inline
+ * @param value_size Bytes per value, 1 to LIST_INLINE_MAX
+ * @return Pointer to the newly created list, or NULL on failure
+ */
+List *list_create_inline(size_t value_size) {
+    if (value_size == 0 || value_size > LIST_INLINE_MAX) {
+        return NULL;
+    }
+    List *list = list_create(LIST_LINKED_SENTINEL);
+    if (list == NULL) {
+        return NULL;
+    }
+    // Whole words keep the value behind the next node aligned
+    list->value_size = value_size;
+    list->pool.stride = sizeof(Node) + ((value_size + 7) & ~(size_t)7);
+    return list;
+}
+
+/**
+ * @brief Create an empty list storing elements the same way as list
+ */
+static List *list_create_like(const List *list) {
+    return list->value_size ? list_create_inline(list->value_size) : list_create(list->type);
+}
+
+/**
+ * @brief Put an element into a node: the pointer itself, or a copy of the
+ * value for inline lists
+ */
+static inline void node_store(const List *list, Node *node, void *data) {
+    if (list->value_size) {
+        memcpy(node_value(node), data, list->value_size);
+        data = node_value(node);
+    }
+    node->data = data;
+}
+
 /**
  * @brief the list and free all associated memory
  * @param list Pointer to the list to destroy
@@ -84,17 +120,21 @@ void list_destroy(List *list, FreeFunc free_func) {
         return;
     }
     
-    // Remove all nodes except sentinel
-    Node *current = list->sentinel->next;
-    while (current != list->sentinel) {
-        Node *next = current->next;
-        if (free_func != NULL && current->data != NULL) {
-            free_func(current->data);
+    // Free the elements, the nodes themselves go away with their slabs
+    if (free_func != NULL && list->value_size == 0) {
+        for (Node *current = list->sentinel->next; current != list->sentinel; current = current->next) {
+            if (current->data != NULL) {
+                free_func(current->data);
+            }
         }
-        free(current);
-        current = next;
     }
     
+    pool_release(&list->pool);
+    lab_unmap(&list->map);
+    lab_compact_release(&list->compact, free_func);
+    lab_xor_release(&list->xor_pool, free_func);
+    string_arena_release(list->arena);
+    free(list->scratch);
     free(list->sentinel);
     free(list);
 }
@@ -107,14 +147,21 @@ void list_destroy(List *list, FreeFunc free_func) {
  * AI Use: Assisted AI
  */
 bool list_append(List *list, void *data) {
-    if (list == NULL) {
+    if (list != NULL && list->type == LIST_COMPACT) {
+        return lab_compact_insert(list, list->size, &data, 1);
+    }
+    if (list != NULL && list->type == LIST_XOR) {
+        return lab_xor_insert(list, list->size, &data, 1);
+    }
+    if (list == NULL || !list_has_chain(list) || (list->value_size && data == NULL)) {
         return false;
     }
     
-    Node *new_node = node_create(data);
+    Node *new_node = pool_alloc_one(&list->pool);
     if (new_node == NULL) {
         return false;
     }
+    node_store(list, new_node, data);
     
     // Insert new node before sentinel (at the end)
     Node *last = list->sentinel->prev;
@@ -137,14 +184,22 @@ bool list_append(List *list, void *data) {
  * AI Use: Assisted AI
  */
 bool list_insert(List *list, size_t index, void *data) {
-    if (list == NULL || index > list->size) {
+    if (list != NULL && list->type == LIST_COMPACT) {
+        return index <= list->size && lab_compact_insert(list, index, &data, 1);
+    }
+    if (list != NULL && list->type == LIST_XOR) {
+        return index <= list->size && lab_xor_insert(list, index, &data, 1);
+    }
+    if (list == NULL || !list_has_chain(list) || index > list->size ||
+        (list->value_size && data == NULL)) {
         return false;
     }
     
-    Node *new_node = node_create(data);
+    Node *new_node = pool_alloc_one(&list->pool);
     if (new_node == NULL) {
         return false;
     }
+    node_store(list, new_node, data);
     
     // Find the position to insert
     Node *current = list->sentinel;
@@ -171,7 +226,13 @@ bool list_insert(List *list, size_t index, void *data) {
  * AI Use: Assisted AI
  */
 void *list_remove(List *list, size_t index) {
-    if (list == NULL || index >= list->size) {
+    if (list != NULL && list->type == LIST_COMPACT && index < list->size) {
+        return lab_compact_remove(list, index);
+    }
+    if (list != NULL && list->type == LIST_XOR && index < list->size) {
+        return lab_xor_remove(list, index);
+    }
+    if (list == NULL || !list_has_chain(list) || index >= list->size) {
         return NULL;
     }
     
@@ -186,7 +247,7 @@ void *list_remove(List *list, size_t index) {
     current->prev->next = current->next;
     current->next->prev = current->prev;
     
-    free(current);
+    pool_free_one(&list->pool, current);
     list->size--;
     
     return data;
@@ -203,6 +264,15 @@ void *list_get(const List *list, size_t index) {
     if (list == NULL || index >= list->size) {
         return NULL;
     }
+    if (list->type == LIST_MAPPED) {
+        return lab_mapped_get(list, index);
+    }
+    if (list->type == LIST_COMPACT) {
+        return lab_compact_get(list, index);
+    }
+    if (list->type == LIST_XOR) {
+        return lab_xor_get(list, index);
+    }
     
     // Find the node at the specified index
     Node *current = list->sentinel->next;
@@ -239,67 +309,732 @@ bool list_is_empty(const List *list) {
     return list->size == 0;
 }
 
+/**
+ * @brief Find the node at a position, walking from whichever end is closer
+ * @param list Pointer to the list
+ * @param index Position in [0, size]; index == size yields the sentinel
+ * @return The node at index
+ */
+static Node *node_at(const List *list, size_t index) {
+    Node *current = list->sentinel;
+    if (index < list->size / 2) {
+        for (size_t i = 0; i <= index; i++) {
+            current = current->next;
+        }
+    } else {
+        for (size_t i = list->size; i > index; i--) {
+            current = current->prev;
+        }
+    }
+    return current;
+}
+
+/**
+ * @brief Split the list in two, moving the nodes from index onwards into a new list
+ * @param list Pointer to the list
+ * @param index Index of the first element to move
+ * @return New list holding the tail, or NULL on failure
+ */
+List *list_split_at(List *list, size_t index) {
+    if (list == NULL || !list_has_chain(list) || index > list->size) {
+        return NULL;
+    }
+
+    List *tail = list_create_like(list);
+    if (tail == NULL || index == list->size) {
+        return tail;
+    }
+    // The moved nodes still live in slabs of the original list
+    if (!pool_share(&tail->pool, &list->pool)) {
+        list_destroy(tail, NULL);
+        return NULL;
+    }
+
+    Node *first = node_at(list, index);
+    Node *last = list->sentinel->prev;
+    Node *keep = first->prev;
+
+    // Close the remaining head
+    keep->next = list->sentinel;
+    list->sentinel->prev = keep;
+
+    // Hang the detached chain off the new sentinel
+    tail->sentinel->next = first;
+    first->prev = tail->sentinel;
+    tail->sentinel->prev = last;
+    last->next = tail->sentinel;
+
+    tail->size = list->size - index;
+    list->size = index;
+    return tail;
+}
+
+/**
+ * @brief Move every node of src into dst before position pos
+ * @param dst Pointer to the destination list
+ * @param pos Index in dst the first element of src ends up at
+ * @param src Pointer to the source list, left empty
+ * @return true on success, false on failure
+ */
+bool list_splice(List *dst, size_t pos, List *src) {
+    if (dst == NULL || src == NULL || dst == src || pos > dst->size ||
+        !list_has_chain(dst) || !list_has_chain(src) || dst->value_size != src->value_size) {
+        return false;
+    }
+    if (src->size == 0) {
+        return true;
+    }
+    if (!pool_take(&dst->pool, &src->pool)) {
+        return false;
+    }
+
+    Node *after = node_at(dst, pos);
+    Node *before = after->prev;
+    Node *first = src->sentinel->next;
+    Node *last = src->sentinel->prev;
+
+    before->next = first;
+    first->prev = before;
+    last->next = after;
+    after->prev = last;
+
+    dst->size += src->size;
+    src->sentinel->next = src->sentinel;
+    src->sentinel->prev = src->sentinel;
+    src->size = 0;
+    return true;
+}
+
+/**
+ * @brief Link n elements into a chain of nodes taken from one block
+ * @param list Pointer to the list that owns the block
+ * @param items Elements to store
+ * @param n Number of elements (> 0)
+ * @param last Receives the last node of the chain
+ * @return The first node of the chain, or NULL on failure
+ */
+static Node *chain_from_items(List *list, void *const *items, size_t n, Node **last) {
+    Node *nodes = pool_alloc(&list->pool, n);
+    if (nodes == NULL) {
+        return NULL;
+    }
+    Node *prev = NULL;
+    Node *node = nodes;
+    for (size_t i = 0; i < n; i++) {
+        Node *next = pool_node(&list->pool, node, 1);
+        node_store(list, node, items[i]);
+        node->prev = prev;
+        node->next = next;
+        prev = node;
+        node = next;
+    }
+    *last = prev;
+    return nodes;
+}
+
+/**
+ * @brief Append n elements to the end of the list
+ * @param list Pointer to the list
+ * @param items Elements to append, in order
+ * @param n Number of elements
+ * @return true on success, false on failure
+ */
+bool list_append_many(List *list, void *const *items, size_t n) {
+    return list != NULL && list_insert_many(list, list->size, items, n);
+}
+
+/**
+ * @brief Insert n elements so that the first of them ends up at index
+ * @param list Pointer to the list
+ * @param index Index at which to insert the elements
+ * @param items Elements to insert, in order
+ * @param n Number of elements
+ * @return true on success, false on failure
+ */
+bool list_insert_many(List *list, size_t index, void *const *items, size_t n) {
+    if (list == NULL || index > list->size || (items == NULL && n > 0)) {
+        return false;
+    }
+    if (list->type == LIST_COMPACT) {
+        return n == 0 || lab_compact_insert(list, index, items, n);
+    }
+    if (list->type == LIST_XOR) {
+        return n == 0 || lab_xor_insert(list, index, items, n);
+    }
+    if (!list_has_chain(list)) {
+        return false;
+    }
+    if (n == 0) {
+        return true;
+    }
+    for (size_t i = 0; list->value_size && i < n; i++) {
+        if (items[i] == NULL) return false;
+    }
+
+    Node *last;
+    Node *first = chain_from_items(list, items, n, &last);
+    if (first == NULL) {
+        return false;
+    }
+
+    Node *after = node_at(list, index);
+    Node *before = after->prev;
+    before->next = first;
+    first->prev = before;
+    last->next = after;
+    after->prev = last;
+
+    list->size += n;
+    return true;
+}
+
+/**
+ * @brief Create a new list holding the elements of an array
+ * @param items Elements to store, in order
+ * @param n Number of elements
+ * @return Pointer to the new list, or NULL on failure
+ */
+List *list_from_array(void *const *items, size_t n) {
+    List *list = list_create(LIST_LINKED_SENTINEL);
+    if (list != NULL && !list_append_many(list, items, n)) {
+        list_destroy(list, NULL);
+        return NULL;
+    }
+    return list;
+}
+
+/**
+ * @brief Copy the element pointers of the list into an array
+ * @param list Pointer to the list
+ * @param out Array receiving at most cap elements
+ * @param cap Capacity of out
+ * @return Number of elements written
+ */
+size_t list_to_array(const List *list, void **out, size_t cap) {
+    if (list == NULL || out == NULL) {
+        return 0;
+    }
+
+    size_t count = 0;
+    ListIter it = list_iter(list);
+    while (count < cap && list_next(&it, &out[count])) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Get an iterator positioned at the ends of the list
+ * @param list Pointer to the list
+ * @return The iterator
+ */
+ListIter list_iter(const List *list) {
+    ListIter it = { list, NULL, NULL, 0 };
+    if (list != NULL) {
+        it.pos = list->type == LIST_COMPACT ? (void *)list->compact.nodes : (void *)list->sentinel;
+        it.index = list->size;
+    }
+    if (list != NULL && list->type == LIST_XOR) {
+        // XOR links need the node on one side to find the other
+        it.pos = (void *)&list->xor_pool.sentinel;
+        it.ahead = list->xor_pool.first;
+    }
+    return it;
+}
+
+/**
+ * @brief Element at the iterator's current position
+ */
+static inline void *iter_data(const ListIter *it) {
+    if (it->list->type == LIST_MAPPED) {
+        return lab_mapped_get(it->list, it->index);
+    }
+    if (it->list->type == LIST_COMPACT) {
+        return ((CompactNode *)it->pos)->data;
+    }
+    if (it->list->type == LIST_XOR) {
+        return ((XorNode *)it->pos)->data;
+    }
+    return ((Node *)it->pos)->data;
+}
+
+/**
+ * @brief Replace the element pointer at the iterator's current position.
+ * Only for lists with nodes of their own that hold pointers.
+ */
+static inline void iter_store(const ListIter *it, void *data) {
+    if (it->list->type == LIST_COMPACT) {
+        ((CompactNode *)it->pos)->data = data;
+    } else if (it->list->type == LIST_XOR) {
+        ((XorNode *)it->pos)->data = data;
+    } else {
+        ((Node *)it->pos)->data = data;
+    }
+}
+
+/**
+ * @brief Advance the iterator to the next element
+ * @param it Pointer to the iterator
+ * @param elem Receives the element (may be NULL)
+ * @return true if it moved to an element, false if it reached the ends
+ */
+bool list_next(ListIter *it, void **elem) {
+    if (it == NULL || it->list == NULL) {
+        return false;
+    }
+    const List *list = it->list;
+
+    // The ends sit between the last and the first element, like the sentinel
+    it->index = it->index == list->size ? 0 : it->index + 1;
+    if (list_has_chain(list)) {
+        it->pos = ((Node *)it->pos)->next;
+    } else if (list->type == LIST_COMPACT) {
+        it->pos = &list->compact.nodes[((CompactNode *)it->pos)->next];
+    } else if (list->type == LIST_XOR) {
+        XorNode *next = it->ahead;
+        it->ahead = xor_step(next, it->pos);
+        it->pos = next;
+    }
+    if (it->index == list->size) {
+        return false;
+    }
+    if (elem != NULL) {
+        *elem = iter_data(it);
+    }
+    return true;
+}
+
+/**
+ * @brief Move the iterator back to the previous element
+ * @param it Pointer to the iterator
+ * @param elem Receives the element (may be NULL)
+ * @return true if it moved to an element, false if it reached the ends
+ */
+bool list_prev(ListIter *it, void **elem) {
+    if (it == NULL || it->list == NULL) {
+        return false;
+    }
+    const List *list = it->list;
+
+    it->index = it->index == 0 ? list->size : it->index - 1;
+    if (list_has_chain(list)) {
+        it->pos = ((Node *)it->pos)->prev;
+    } else if (list->type == LIST_COMPACT) {
+        it->pos = &list->compact.nodes[((CompactNode *)it->pos)->prev];
+    } else if (list->type == LIST_XOR) {
+        XorNode *prev = xor_step(it->pos, it->ahead);
+        it->ahead = it->pos;
+        it->pos = prev;
+    }
+    if (it->index == list->size) {
+        return false;
+    }
+    if (elem != NULL) {
+        *elem = iter_data(it);
+    }
+    return true;
+}
+
 //P2
 
 /**
- * @brief Sorts a portion of the list between start and end indices (inclusive)
- * using bubble sort and the given compare function.
+ * @brief Select how sort() handles this list.
  */
-void sort(List *list, size_t start, size_t end, CompareFunc cmp) {
-    if (!list || start >= end || end >= list->size) return;
+bool list_set_sort_options(List *list, const SortOptions *opts) {
+    if (!list) return false;
+
+    list->sort_opts = opts ? *opts : SORT_OPTIONS_DEFAULT;
+    if (!list->sort_opts.reuse_scratch) {
+        free(list->scratch);
+        list->scratch = NULL;
+        list->scratch_bytes = 0;
+    }
+    return true;
+}
 
-    for (size_t i = start; i < end; i++) {
-        Node *a = list->sentinel->next;
-        for (size_t k = 0; k < i; k++) {
-            a = a->next;
+/**
+ * @brief Iterator from which list_next() yields the element at index
+ * (<= size). Walks from whichever end is closer.
+ */
+static ListIter iter_before(const List *list, size_t index) {
+    ListIter it = list_iter(list);
+    if (index <= list->size / 2) {
+        for (size_t i = 0; i < index; i++) {
+            list_next(&it, NULL);
+        }
+    } else {
+        for (size_t i = list->size; i >= index; i--) {
+            list_prev(&it, NULL);
         }
-        for (size_t j = start; j < end - (i - start); j++) {
-            Node *b = a->next;
-            if (cmp(a->data, b->data) > 0) {
-                void *tmp = a->data;
-                a->data = b->data;
-                b->data = tmp;
+    }
+    return it;
+}
+
+/**
+ * @brief Bubble sort on the count elements that list_next() yields from
+ * from. Adjacent elements trade places, so the sort is stable.
+ */
+static void bubble_sort_range(const List *list, ListIter from, size_t count,
+                              CompareFuncCtx cmp, void *ctx) {
+    for (size_t pass = 1; pass < count; pass++) {
+        ListIter a = from;
+        void *da;
+        list_next(&a, &da);
+        for (size_t j = 0; j < count - pass; j++) {
+            ListIter b = a;
+            void *db;
+            list_next(&b, &db);
+            if (cmp(da, db, ctx) > 0) {
+                // Inline values trade places, their pointers stay with the nodes
+                if (list->value_size) {
+                    unsigned char tmp[LIST_INLINE_MAX];
+                    memcpy(tmp, da, list->value_size);
+                    memcpy(da, db, list->value_size);
+                    memcpy(db, tmp, list->value_size);
+                } else {
+                    iter_store(&a, db);
+                    iter_store(&b, da);
+                    db = da;
+                }
             }
             a = b;
+            da = db;
         }
     }
 }
 
+/**
+ * @brief Get a spill array of at least bytes bytes, reusing the list's scratch.
+ * @return The array, or NULL on failure. Release it with spill_release().
+ */
+static void *spill_acquire(List *list, size_t bytes) {
+    if (bytes <= list->scratch_bytes) {
+        return list->scratch;
+    }
+    void *buf = malloc(bytes);
+    if (buf && list->sort_opts.reuse_scratch) {
+        free(list->scratch);
+        list->scratch = buf;
+        list->scratch_bytes = bytes;
+    }
+    return buf;
+}
+
+static void spill_release(List *list, void *buf) {
+    if (buf != list->scratch) {
+        free(buf);
+    }
+}
+
+/**
+ * @brief Write sorted elements back into the count positions from it on.
+ * Inline values are gathered into a copy first, since the nodes they are
+ * read from are the ones being overwritten.
+ * @return false if the copy could not be allocated (the list is unchanged).
+ */
+static bool store_sorted(const List *list, ListIter it, void *const *items, size_t count) {
+    if (list->value_size == 0) {
+        for (size_t i = 0; i < count; i++) {
+            list_next(&it, NULL);
+            iter_store(&it, items[i]);
+        }
+        return true;
+    }
+
+    size_t size = list->value_size;
+    unsigned char *values = malloc(size * count);
+    if (!values) return false;
+    for (size_t i = 0; i < count; i++) {
+        memcpy(values + i * size, items[i], size);
+    }
+    for (size_t i = 0; i < count; i++) {
+        void *dst;
+        list_next(&it, &dst);
+        memcpy(dst, values + i * size, size);
+    }
+    free(values);
+    return true;
+}
+
+/**
+ * @brief Gather the range into an array, sort it stably and write it back.
+ * Works on every list type with nodes of its own, through iterators.
+ * When called through sort(), plain is its compare function: compare_int,
+ * compare_str and compare_arena_str are recognized and sorted with pdqsort
+ * instantiations so their comparison is inlined (see lab_stable_sort()).
+ * Anything else goes through introsort with cmp and ctx.
+ * @return false if no spill array could be allocated.
+ */
+static bool spill_sort_range(List *list, ListIter from, size_t count,
+                             CompareFuncCtx cmp, void *ctx, CompareFunc plain) {
+    ListIter it = from;
+
+    // Equal inline ints are indistinguishable, so their order needs no tie-break
+    if (plain == compare_int && list->value_size == sizeof(int)) {
+        ListIntKey *keys = spill_acquire(list, sizeof(ListIntKey) * count);
+        if (!keys) return false;
+        for (size_t i = 0; i < count; i++) {
+            list_next(&it, &keys[i].data);
+            keys[i].key = *(const int *)keys[i].data;
+        }
+        list_sort_int_keys_desc(keys, count);
+        it = from;
+        for (size_t i = 0; i < count; i++) {
+            void *dst;
+            list_next(&it, &dst);
+            *(int *)dst = keys[i].key;
+        }
+        spill_release(list, keys);
+        return true;
+    }
+
+    void **items = spill_acquire(list, sizeof(void *) * count);
+    if (!items) return false;
+    for (size_t i = 0; i < count; i++) {
+        list_next(&it, &items[i]);
+    }
+    bool ok = lab_stable_sort(items, count, cmp, ctx, plain) &&
+              store_sorted(list, from, items, count);
+    spill_release(list, items);
+    return ok;
+}
+
+/**
+ * @brief Sort the range with the list's strategy, see spill_sort_range()
+ * for plain.
+ */
+static void sort_range(List *list, size_t start, size_t end,
+                       CompareFuncCtx cmp, void *ctx, CompareFunc plain) {
+    if (!list || !cmp || start >= end || end >= list->size) return;
+    // Mapped lists are read-only
+    if (list->type == LIST_MAPPED) return;
+
+    ListIter from = iter_before(list, start);
+    size_t count = end - start + 1;
+
+    // Spilling falls back to sorting in place if the array cannot be allocated
+    if (list->sort_opts.strategy == SORT_SPILL && count >= list->sort_opts.spill_threshold &&
+        spill_sort_range(list, from, count, cmp, ctx, plain)) {
+        return;
+    }
+    bubble_sort_range(list, from, count, cmp, ctx);
+}
+
+/**
+ * @brief Sorts a portion of the list between start and end indices (inclusive)
+ * using the list's sort strategy and the given compare function.
+ */
+void sort(List *list, size_t start, size_t end, CompareFunc cmp) {
+    if (!cmp) return;
+    sort_range(list, start, end, lab_plain_compare, &(PlainCompare){ cmp }, cmp);
+}
+
+/**
+ * @brief sort() with a compare function that takes a context pointer.
+ */
+void sort_ctx(List *list, size_t start, size_t end, CompareFuncCtx cmp, void *ctx) {
+    sort_range(list, start, end, cmp, ctx, NULL);
+}
+
 /**
  * @brief Merges two sorted lists into a new sorted list.
  */
 List *merge(const List *a, const List *b, CompareFunc cmp) {
+    if (!cmp) return NULL;
+    return merge_ctx(a, b, lab_plain_compare, &(PlainCompare){ cmp });
+}
+
+/**
+ * @brief merge() with a compare function that takes a context pointer.
+ */
+List *merge_ctx(const List *a, const List *b, CompareFuncCtx cmp, void *ctx) {
     if (!a || !b || !cmp) return NULL;
 
-    List *out = list_create(LIST_LINKED_SENTINEL);
-    if (!out) return NULL;
+    List *out = list_create(lab_merge_type(a, b));
+    if (!out || !lab_share_values(out, a) || !lab_share_values(out, b)) {
+        list_destroy(out, NULL);
+        return NULL;
+    }
 
-    Node *na = a->sentinel->next;
-    Node *nb = b->sentinel->next;
+    // Iterators, so that mapped lists can be merged too
+    ListIter ia = list_iter(a);
+    ListIter ib = list_iter(b);
+    void *ea;
+    void *eb;
+    bool has_a = list_next(&ia, &ea);
+    bool has_b = list_next(&ib, &eb);
 
-    while (na != a->sentinel && nb != b->sentinel) {
-        if (cmp(na->data, nb->data) <= 0) {
-            list_append(out, na->data);
-            na = na->next;
+    while (has_a && has_b) {
+        if (cmp(ea, eb, ctx) <= 0) {
+            list_append(out, ea);
+            has_a = list_next(&ia, &ea);
         } else {
-            list_append(out, nb->data);
-            nb = nb->next;
+            list_append(out, eb);
+            has_b = list_next(&ib, &eb);
+        }
+    }
+
+    while (has_a) {
+        list_append(out, ea);
+        has_a = list_next(&ia, &ea);
+    }
+
+    while (has_b) {
+        list_append(out, eb);
+        has_b = list_next(&ib, &eb);
+    }
+
+    return out;
+}
+
+/**
+ * @brief Keep the nodes of an inline list alive while out points into them.
+ */
+bool lab_share_values(List *out, const List *in) {
+    return in == NULL || in->value_size == 0 || pool_share(&out->pool, &in->pool);
+}
+
+/**
+ * @brief Restore the heap property below slot i of a cursor heap.
+ * Cursors compare by their current element; ties go to the lower list index
+ * so that equal elements keep the order of the input lists.
+ */
+static void cursor_sift_down(void **heads, size_t *heap, size_t count, size_t i,
+                             CompareFuncCtx cmp, void *ctx) {
+    for (;;) {
+        size_t best = i;
+        for (size_t c = 2 * i + 1; c <= 2 * i + 2 && c < count; c++) {
+            int r = cmp(heads[heap[c]], heads[heap[best]], ctx);
+            if (r < 0 || (r == 0 && heap[c] < heap[best])) {
+                best = c;
+            }
+        }
+        if (best == i) return;
+        size_t tmp = heap[i];
+        heap[i] = heap[best];
+        heap[best] = tmp;
+        i = best;
+    }
+}
+
+/**
+ * @brief Merges k sorted lists into a new sorted list with a binary heap.
+ */
+List *list_merge_k(List *const *lists, size_t k, CompareFunc cmp) {
+    if (!cmp) return NULL;
+    return list_merge_k_ctx(lists, k, lab_plain_compare, &(PlainCompare){ cmp });
+}
+
+/**
+ * @brief list_merge_k() with a compare function that takes a context pointer.
+ */
+List *list_merge_k_ctx(List *const *lists, size_t k, CompareFuncCtx cmp, void *ctx) {
+    if (!lists || !cmp) return NULL;
+
+    // All inputs must agree for the result to keep their type
+    const List *first = NULL;
+    ListType type = LIST_LINKED_SENTINEL;
+    for (size_t i = 0; i < k; i++) {
+        if (!lists[i]) continue;
+        if (!first) {
+            first = lists[i];
+            type = lab_merge_type(first, first);
+        } else if (lab_merge_type(first, lists[i]) != type) {
+            type = LIST_LINKED_SENTINEL;
         }
     }
+    List *out = list_create(type);
+    ListIter *iters = malloc(sizeof(ListIter) * (k ? k : 1));
+    void **heads = malloc(sizeof(void *) * (k ? k : 1));
+    size_t *heap = malloc(sizeof(size_t) * (k ? k : 1));
+    bool shared = out != NULL;
+    for (size_t i = 0; shared && i < k; i++) {
+        shared = lab_share_values(out, lists[i]);
+    }
+    if (!shared || !iters || !heads || !heap) {
+        free(heap);
+        free(heads);
+        free(iters);
+        list_destroy(out, NULL);
+        return NULL;
+    }
 
-    while (na != a->sentinel) {
-        list_append(out, na->data);
-        na = na->next;
+    size_t count = 0;
+    for (size_t i = 0; i < k; i++) {
+        iters[i] = list_iter(lists[i]);
+        if (list_next(&iters[i], &heads[i])) {
+            heap[count++] = i;
+        }
+    }
+    for (size_t i = count / 2; i-- > 0;) {
+        cursor_sift_down(heads, heap, count, i, cmp, ctx);
     }
 
-    while (nb != b->sentinel) {
-        list_append(out, nb->data);
-        nb = nb->next;
+    while (count > 0) {
+        size_t src = heap[0];
+        if (!list_append(out, heads[src])) {
+            list_destroy(out, NULL);
+            out = NULL;
+            break;
+        }
+        if (!list_next(&iters[src], &heads[src])) {
+            heap[0] = heap[--count];
+        }
+        cursor_sift_down(heads, heap, count, 0, cmp, ctx);
     }
 
+    free(heap);
+    free(heads);
+    free(iters);
     return out;
 }
 
+/**
+ * @brief Move the nodes of a list into parts new lists of near equal size.
+ */
+bool list_partition(List *list, size_t parts, List **out) {
+    if (!list || !out || parts == 0 || !list_has_chain(list)) return false;
+
+    for (size_t p = 0; p < parts; p++) {
+        out[p] = list_create_like(list);
+        if (out[p] != NULL && !pool_share(&out[p]->pool, &list->pool)) {
+            list_destroy(out[p], NULL);
+            out[p] = NULL;
+        }
+        if (out[p] == NULL) {
+            while (p-- > 0) {
+                list_destroy(out[p], NULL);
+            }
+            return false;
+        }
+    }
+
+    // One walk: hand each run of consecutive nodes to its part
+    Node *cur = list->sentinel->next;
+    for (size_t p = 0; p < parts; p++) {
+        size_t count = list->size * (p + 1) / parts - list->size * p / parts;
+        if (count == 0) continue;
+
+        Node *first = cur;
+        Node *last = cur;
+        for (size_t i = 1; i < count; i++) {
+            last = last->next;
+        }
+        cur = last->next;
+
+        Node *s = out[p]->sentinel;
+        s->next = first;
+        first->prev = s;
+        s->prev = last;
+        last->next = s;
+        out[p]->size = count;
+    }
+
+    list->sentinel->next = list->sentinel;
+    list->sentinel->prev = list->sentinel;
+    list->size = 0;
+    return true;
+}
 
 /**
  * @brief Compare integers in descending order.
@@ -307,7 +1042,7 @@ List *merge(const List *a, const List *b, CompareFunc cmp) {
 int compare_int(const void *a, const void *b) {
     int ia = *(const int *)a;
     int ib = *(const int *)b;
-    return (ib - ia);  // bigger first (descending)
+    return (ia < ib) - (ia > ib);  // bigger first (descending), no overflow
 }
 
 /**
@@ -323,14 +1058,24 @@ int compare_str(const void *a, const void *b) {
  * @brief Checks if the list is sorted according to cmp.
  */
 bool is_sorted(const List *list, CompareFunc cmp) {
+    return is_sorted_ctx(list, lab_plain_compare, &(PlainCompare){ cmp });
+}
+
+/**
+ * @brief is_sorted() with a compare function that takes a context pointer.
+ */
+bool is_sorted_ctx(const List *list, CompareFuncCtx cmp, void *ctx) {
     if (!list || list->size < 2) return true;
 
-    Node *cur = list->sentinel->next;
-    while (cur->next != list->sentinel) {
-        if (cmp(cur->data, cur->next->data) > 0) {
+    ListIter it = list_iter(list);
+    void *prev;
+    void *cur;
+    list_next(&it, &prev);
+    while (list_next(&it, &cur)) {
+        if (cmp(prev, cur, ctx) > 0) {
             return false;
         }
-        cur = cur->next;
+        prev = cur;
     }
     return true;
 }
\ No newline at end of file
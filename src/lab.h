@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /**
  * @file lab.h
@@ -15,7 +16,29 @@ typedef struct List List;
  * @brief Enumeration for selecting the list implementation type.
  */
 typedef enum {
-    LIST_LINKED_SENTINEL
+    LIST_LINKED_SENTINEL,
+    LIST_MAPPED,    /**< Read-only view of a saved file, made by list_map_file(), not list_create(). */
+    /**
+     * Nodes of 16 bytes instead of 24: the element pointer and 32 bit next
+     * and prev slot indices into one growable array, so a list holds fewer
+     * than 2^32 elements. Supports list_append(), list_insert(),
+     * list_append_many(), list_insert_many(), list_remove(), list_get(),
+     * list_iter(), sort() and sort_ctx(), plus everything that only reads a
+     * list (is_sorted(), merge inputs, list_to_array(), list_top_k(),
+     * list_save(), ...).
+     * merge() and list_merge_k() return a compact list when every input is one.
+     * Operations that move nodes between lists fail on it.
+     */
+    LIST_COMPACT,
+    /**
+     * Nodes of 16 bytes holding the element pointer and the addresses of
+     * both neighbours XORed into one field, with no limit on the length.
+     * Supports the same operations as LIST_COMPACT; list_append() and
+     * list_insert() at either end take constant time, anywhere else they
+     * walk from the closer end. merge() and list_merge_k() return an XOR
+     * list when every input is one.
+     */
+    LIST_XOR
 } ListType;
 
 /**
@@ -34,6 +57,31 @@ typedef void (*FreeFunc)(void *);
  */
 List *list_create(ListType type);
 
+/**
+ * @brief Largest value size list_create_inline() accepts.
+ */
+#define LIST_INLINE_MAX 16
+
+/**
+ * @brief Create a LIST_LINKED_SENTINEL list that stores values in its nodes.
+ * Every node carries value_size bytes right behind its links, so there is
+ * no payload allocation per element and a node and its value share a cache
+ * line. list_append() and the other insertion functions copy value_size
+ * bytes from the pointer they are given, and list_get(), list_iter() and
+ * every compare function see pointers into the nodes. Values are aligned
+ * for pointers and 8 byte integers.
+ *
+ * The pointer list_remove() returns stays valid until the next insertion.
+ * list_destroy() ignores free_func. Sorting moves values between nodes, so
+ * element pointers taken before a sort see other values afterwards. Lists
+ * made by merge(), list_merge_k() and list_merge_parallel() hold pointers
+ * into the inputs' nodes and keep them alive. list_splice() only accepts
+ * lists with the same value size.
+ * @param value_size Bytes per value, 1 to LIST_INLINE_MAX.
+ * @return Pointer to the newly created list, or NULL on failure.
+ */
+List *list_create_inline(size_t value_size);
+
 /**
  * @brief Destroy the list and free all associated memory.
  * @param list Pointer to the list to destroy.
@@ -58,6 +106,47 @@ bool list_append(List *list, void *data);
  */
 bool list_insert(List *list, size_t index, void *data);
 
+/**
+ * @brief Append several elements to the end of the list.
+ * The nodes are allocated as one block and linked in a single pass.
+ * @param list Pointer to the list.
+ * @param items Array of n elements to append, in order.
+ * @param n Number of elements.
+ * @return true on success, false on failure (the list is unchanged).
+ */
+bool list_append_many(List *list, void *const *items, size_t n);
+
+/**
+ * @brief Insert several elements starting at a specific index.
+ * The nodes are allocated as one block and the position is located with a
+ * single walk, so this costs O(min(index, size - index) + n).
+ * @param list Pointer to the list.
+ * @param index Index at which the first element ends up.
+ * @param items Array of n elements to insert, in order.
+ * @param n Number of elements.
+ * @return true on success, false on failure (e.g., index out of bounds).
+ */
+bool list_insert_many(List *list, size_t index, void *const *items, size_t n);
+
+/**
+ * @brief Create a new list from an array of elements.
+ * All nodes come from a single contiguous allocation.
+ * @param items Array of n elements, in order.
+ * @param n Number of elements.
+ * @return Pointer to the newly created list, or NULL on failure.
+ */
+List *list_from_array(void *const *items, size_t n);
+
+/**
+ * @brief Copy the elements of the list into a caller provided array.
+ * Walks the list once, so this is O(n) rather than n calls to list_get.
+ * @param list Pointer to the list.
+ * @param out Array receiving the elements in list order.
+ * @param cap Capacity of out; at most cap elements are written.
+ * @return The number of elements written.
+ */
+size_t list_to_array(const List *list, void **out, size_t cap);
+
 /**
  * @brief Remove an element at a specific index.
  * @param list Pointer to the list.
@@ -88,6 +177,65 @@ size_t list_size(const List *list);
  */
 bool list_is_empty(const List *list);
 
+/**
+ * @struct ListIter
+ * @brief Bidirectional cursor over a list of any type.
+ * A fresh iterator sits at the ends of the list: list_next() then yields the
+ * elements front to back and list_prev() back to front, both returning false
+ * once they are back at the ends. The list must not be modified while it is
+ * being iterated.
+ */
+typedef struct {
+    const List *list;   /**< List being iterated. */
+    void *pos;          /**< Current node (internal). */
+    void *ahead;        /**< Node after pos, LIST_XOR only (internal). */
+    size_t index;       /**< Index of the current element, the list size at the ends. */
+} ListIter;
+
+/**
+ * @brief Get an iterator positioned at the ends of the list.
+ * @param list Pointer to the list.
+ * @return The iterator.
+ */
+ListIter list_iter(const List *list);
+
+/**
+ * @brief Advance the iterator to the next element.
+ * @param it Pointer to the iterator.
+ * @param elem Receives the element (may be NULL).
+ * @return true if it moved to an element, false if it reached the ends.
+ */
+bool list_next(ListIter *it, void **elem);
+
+/**
+ * @brief Move the iterator back to the previous element.
+ * @param it Pointer to the iterator.
+ * @param elem Receives the element (may be NULL).
+ * @return true if it moved to an element, false if it reached the ends.
+ */
+bool list_prev(ListIter *it, void **elem);
+
+/**
+ * @brief Split the list in two, moving the elements from index onwards into a new list.
+ * No nodes are allocated or copied; the tail nodes change owner. The walk to
+ * index starts from whichever end of the list is closer.
+ * @param list Pointer to the list, keeps elements [0, index).
+ * @param index Index of the first element to move (index == size yields an empty list).
+ * @return New list holding the former tail, or NULL on failure (e.g., index out of bounds).
+ */
+List *list_split_at(List *list, size_t index);
+
+/**
+ * @brief Move all elements of src into dst so that they start at index pos.
+ * Once pos is located this is O(1) pointer surgery; src is left empty but
+ * still has to be destroyed by the caller.
+ * @param dst Pointer to the destination list.
+ * @param pos Index in dst at which to insert (pos == size appends).
+ * @param src Pointer to the source list.
+ * @return true on success, false on failure (e.g., pos out of bounds).
+ */
+bool list_splice(List *dst, size_t pos, List *src);
+
 //P2
 /**
  * @typedef CompareFunc
@@ -96,10 +244,483 @@ bool list_is_empty(const List *list);
  */
 typedef int (*CompareFunc)(const void *, const void *);
 
+/**
+ * @typedef CompareFuncCtx
+ * @brief Compare function that also receives a caller supplied context.
+ * Same return convention as CompareFunc. The context carries settings such
+ * as a key offset or sort direction, so differently configured sorts can
+ * run at the same time without globals. The context is only read through
+ * this pointer and is passed unchanged to every call.
+ */
+typedef int (*CompareFuncCtx)(const void *, const void *, void *ctx);
+
+/**
+ * @enum SortStrategy
+ * @brief How sort() orders a range of the list.
+ */
+typedef enum {
+    SORT_BUBBLE,    /**< Swap adjacent elements in place on the nodes (stable, O(n^2)). */
+    SORT_SPILL      /**< Gather the range into an array, sort it, scatter back (stable).
+                         compare_int and compare_str use inlined pdqsorts, others introsort,
+                         with ties broken by position. */
+} SortStrategy;
+
+/**
+ * @struct SortOptions
+ * @brief Per-list settings for sort().
+ */
+typedef struct {
+    SortStrategy strategy;  /**< Strategy for ranges of at least spill_threshold elements. */
+    size_t spill_threshold; /**< Shorter ranges always use SORT_BUBBLE. */
+    bool reuse_scratch;     /**< Keep the spill array in the list for the next sort. */
+} SortOptions;
+
+/**
+ * @brief Default sort options: SORT_SPILL for ranges of 16 or more elements,
+ * no scratch reuse.
+ */
+#define SORT_OPTIONS_DEFAULT ((SortOptions){ SORT_SPILL, 16, false })
+
+/**
+ * @brief Select how sort() handles this list.
+ * With reuse_scratch set, concurrent sort() calls on disjoint ranges of the
+ * same list are not allowed since they would share the scratch array.
+ * @param list Pointer to the list.
+ * @param opts Options to use, or NULL for SORT_OPTIONS_DEFAULT.
+ * @return true on success, false on failure.
+ */
+bool list_set_sort_options(List *list, const SortOptions *opts);
+
+/**
+ * @brief Sort the elements between start and end (inclusive) using the
+ * strategy selected with list_set_sort_options().
+ * Every strategy is stable: equal elements keep their relative order.
+ */
 void sort(List *list, size_t start, size_t end, CompareFunc cmp);
 List *merge(const List *list1, const List *list2, CompareFunc cmp);
+
+/**
+ * @brief sort() with a compare function that takes a context pointer.
+ * The inlined compare_int/compare_str fast paths do not apply here.
+ * @param list Pointer to the list.
+ * @param start Index of the first element to sort.
+ * @param end Index of the last element to sort (inclusive).
+ * @param cmp Compare function.
+ * @param ctx Context passed to every cmp call.
+ */
+void sort_ctx(List *list, size_t start, size_t end, CompareFuncCtx cmp, void *ctx);
+
+/**
+ * @brief merge() with a compare function that takes a context pointer.
+ * @param list1 First sorted list.
+ * @param list2 Second sorted list.
+ * @param cmp Compare function the inputs are sorted by.
+ * @param ctx Context passed to every cmp call.
+ * @return New sorted list, or NULL on failure.
+ */
+List *merge_ctx(const List *list1, const List *list2, CompareFuncCtx cmp, void *ctx);
+
+/**
+ * @brief Sort a range of int elements in compare_int order using SIMD kernels.
+ * The int values are gathered into an array, sorted with
+ * list_sort_ints_desc() (see lab_sort.h) and written back into the existing
+ * payloads in order; nodes keep their data pointers. Every element in the
+ * range must point to its own int.
+ * @param list Pointer to a list of int pointers.
+ * @param start Index of the first element to sort.
+ * @param end Index of the last element to sort (inclusive).
+ * @return true on success, false on failure (e.g., end out of bounds).
+ */
+bool list_sort_int(List *list, size_t start, size_t end);
+
+/**
+ * @brief Check if a list of int elements is in compare_int order.
+ * Keys are gathered from the chain into a small stack buffer in batches and
+ * adjacent keys are compared with SIMD (AVX2 or SSE4.1, chosen at runtime),
+ * avoiding one indirect compare call per pair.
+ * @param list Pointer to a list of int pointers.
+ * @return true if the list is sorted, false otherwise.
+ */
+bool list_is_sorted_int(const List *list);
+
+/**
+ * @typedef KeyFunc
+ * @brief Function pointer type for extracting a sort key from an element.
+ * Writes the key of elem into key, which has room for key_size bytes.
+ */
+typedef void (*KeyFunc)(const void *elem, void *key);
+
+/**
+ * @brief Key comparators for fixed-width integer keys (ascending).
+ * Passing one of these to list_sort_by_key() with the matching key_size
+ * selects radix sort.
+ */
+int compare_key_i32(const void *a, const void *b);
+int compare_key_u32(const void *a, const void *b);
+int compare_key_i64(const void *a, const void *b);
+int compare_key_u64(const void *a, const void *b);
+
+/**
+ * @brief Sort the whole list by keys computed once per element.
+ * key_fn is called exactly once for each element and the keys are stored
+ * in one contiguous array, so an expensive key (e.g., a parsed field) is not
+ * recomputed on every comparison. The keys are sorted together with their
+ * nodes and the nodes are relinked in key order. The sort is stable. With
+ * compare_key_i32/u32 (key_size 4) or compare_key_i64/u64 (key_size 8) an
+ * LSD radix sort is used instead of comparisons.
+ * @param list Pointer to the list.
+ * @param key_fn Key extraction function.
+ * @param key_size Size of one key in bytes.
+ * @param key_cmp Compare function applied to pointers to two keys.
+ * @return true on success, false on failure (the list is unchanged).
+ */
+bool list_sort_by_key(List *list, KeyFunc key_fn, size_t key_size, CompareFunc key_cmp);
+
+/**
+ * @brief Sort only the first k positions of the list.
+ * One pass over the chain keeps the k best elements in a bounded heap, so
+ * the cost is O(n log k). Those nodes are then moved, in sorted order, to
+ * the front of the list; the remaining elements keep their relative order.
+ * @param list Pointer to the list.
+ * @param k Number of leading positions to sort (k >= size sorts everything).
+ * @param cmp Compare function.
+ * @return true on success, false on failure.
+ */
+bool list_partial_sort(List *list, size_t k, CompareFunc cmp);
+
+/**
+ * @brief Copy the k best elements of the list, in sorted order, into out.
+ * Same O(n log k) single pass as list_partial_sort() but the list is not
+ * modified. Among equal elements the earlier ones in the list are kept, and
+ * they come out in list order.
+ * @param list Pointer to the list.
+ * @param k Number of elements wanted.
+ * @param cmp Compare function.
+ * @param out Array with room for k elements.
+ * @return The number of elements written, min(k, size), or 0 on failure.
+ */
+size_t list_top_k(const List *list, size_t k, CompareFunc cmp, void **out);
+
+/**
+ * @brief Return the element that would sit at index k after sorting.
+ * The data pointers are spilled into an array and placed with introselect,
+ * linear expected time and O(n log n) worst case. The list is not modified.
+ * @param list Pointer to the list.
+ * @param k Zero based rank.
+ * @param cmp Compare function.
+ * @return The element, or NULL if k is out of range or on failure.
+ */
+void *list_select(const List *list, size_t k, CompareFunc cmp);
+
+/**
+ * @brief Look up several quantiles with a single selection pass.
+ * Quantile q maps to rank floor(q * (size - 1)), q is clamped to [0, 1]
+ * and a NaN q makes the call fail without writing out.
+ * All ranks are placed by one multi-rank introselect over the same array,
+ * which costs far less than a full sort or one list_select() per rank.
+ * @param list Pointer to the list.
+ * @param qs Quantiles to compute, in any order.
+ * @param nq Number of quantiles.
+ * @param cmp Compare function.
+ * @param out Receives the element for qs[i] at out[i].
+ * @return true on success, false on failure, for an empty list or a NaN q.
+ */
+bool list_quantiles(const List *list, const double *qs, size_t nq, CompareFunc cmp, void **out);
 int compare_int(const void *a, const void *b);
 int compare_str(const void *a, const void *b);
 bool is_sorted(const List *list, CompareFunc cmp);
 
+/**
+ * @brief is_sorted() with a compare function that takes a context pointer.
+ * @param list Pointer to the list.
+ * @param cmp Compare function.
+ * @param ctx Context passed to every cmp call.
+ * @return true if the list is sorted, false otherwise.
+ */
+bool is_sorted_ctx(const List *list, CompareFuncCtx cmp, void *ctx);
+
+/**
+ * @brief Merge k sorted lists into a new sorted list.
+ * Uses a binary heap over the heads of the inputs, so the cost is
+ * O(n log k). Equal elements keep the order of the input lists.
+ * @param lists Array of k sorted lists; NULL entries are skipped.
+ * @param k Number of lists.
+ * @param cmp Compare function the inputs are sorted by.
+ * @return New list sharing the data pointers of the inputs, or NULL on failure.
+ */
+List *list_merge_k(List *const *lists, size_t k, CompareFunc cmp);
+
+/**
+ * @brief list_merge_k() with a compare function that takes a context pointer.
+ * @param lists Array of k sorted lists; NULL entries are skipped.
+ * @param k Number of lists.
+ * @param cmp Compare function the inputs are sorted by.
+ * @param ctx Context passed to every cmp call.
+ * @return New list sharing the data pointers of the inputs, or NULL on failure.
+ */
+List *list_merge_k_ctx(List *const *lists, size_t k, CompareFuncCtx cmp, void *ctx);
+
+/**
+ * @brief Move all nodes of a list into parts new lists of contiguous elements.
+ * Walks the chain once and allocates no nodes. The source list is left empty
+ * and the parts differ in size by at most one element.
+ * @param list Pointer to the list to split up.
+ * @param parts Number of lists to create.
+ * @param out Array receiving the parts new lists.
+ * @return true on success, false on failure (the source is unchanged).
+ */
+bool list_partition(List *list, size_t parts, List **out);
+
+/* === String arena === */
+
+/**
+ * @struct StringArena
+ * @brief Packed storage for C strings with bulk release.
+ * Strings are copied back to back into large chunks, so building a list of
+ * them costs no malloc per string, neighbouring strings share cache lines
+ * and everything is freed at once. Each string is preceded by its first 8
+ * bytes as a big endian integer, which compare_arena_str() uses to decide
+ * most comparisons without reading the rest of the string. That prefix
+ * costs 8 bytes per string and is always stored.
+ * An arena is not thread safe while strings are added; its strings can be
+ * read and compared from any thread.
+ */
+typedef struct StringArena StringArena;
+
+/**
+ * @brief Create an empty string arena.
+ * @param intern If true, adding a string that is already in the arena
+ * returns the existing copy, so equal strings share one pointer.
+ * @return New arena holding one reference, or NULL on failure.
+ */
+StringArena *string_arena_create(bool intern);
+
+/**
+ * @brief Copy len bytes of s (plus a terminator) into the arena.
+ * @param arena Pointer to the arena.
+ * @param s Bytes of the string, which should not contain a NUL.
+ * @param len Number of bytes.
+ * @return The arena copy, valid until the arena is released, or NULL on failure.
+ */
+const char *string_arena_add(StringArena *arena, const char *s, size_t len);
+
+/**
+ * @brief Drop one reference to the arena; the last one frees every string
+ * in O(number of chunks).
+ * @param arena Pointer to the arena (can be NULL).
+ */
+void string_arena_release(StringArena *arena);
+
+/**
+ * @brief Make the list hold a reference to the arena, dropped by
+ * list_destroy(). Destroy such a list with a NULL free_func. Lists created
+ * from it (split, merge, partition) do not hold a reference of their own.
+ * @param list Pointer to the list.
+ * @param arena Arena the list's strings live in.
+ * @return true on success, false if the list already holds an arena.
+ */
+bool list_attach_arena(List *list, StringArena *arena);
+
+/**
+ * @brief Compare two strings from a StringArena in strcmp order.
+ * Uses the cached prefixes and reads the strings only if those are equal.
+ * Sorting with it copies each prefix next to its pointer and sorts those
+ * pairs with an inlined pdqsort, so the strings are only read on ties.
+ * Only valid for strings returned by string_arena_add().
+ */
+int compare_arena_str(const void *a, const void *b);
+
+/* === Serialization === */
+
+/**
+ * @brief Returned by ListCodec.decode for malformed input or when the
+ * element cannot be allocated.
+ */
+#define LIST_CODEC_ERROR SIZE_MAX
+
+/**
+ * @struct ListCodec
+ * @brief Callbacks that turn elements into bytes and back for list_save()
+ * and list_load().
+ */
+typedef struct {
+    uint32_t tag;   /**< Stored in the file header; list_load() rejects files with another tag. */
+    size_t (*encoded_size)(const void *elem);               /**< Bytes encode() writes for elem. */
+    void (*encode)(const void *elem, unsigned char *out);   /**< Write the encoding of elem to out. */
+    /**
+     * Decode one element from the avail bytes at in into *elem. Returns
+     * the number of bytes consumed, 0 if the element continues past avail,
+     * or LIST_CODEC_ERROR.
+     */
+    size_t (*decode)(const unsigned char *in, size_t avail, void **elem);
+    FreeFunc free_elem;  /**< Frees a decoded element, used when loading fails. */
+    size_t fixed_size;   /**< Encoded size of every element, 0 if it varies. */
+    /**
+     * Return the element as stored in encoded bytes, without copying, for
+     * list_map_file(). NULL if the encoding cannot be used in place.
+     */
+    const void *(*view)(const unsigned char *in);
+    /**
+     * Size of the encoded element at in without decoding it: 0 if it
+     * continues past avail, or LIST_CODEC_ERROR. Optional; together with
+     * view it lets list_external_sort() work on elements in place.
+     */
+    size_t (*measure)(const unsigned char *in, size_t avail);
+} ListCodec;
+
+/**
+ * @brief Codec for int elements: 4 bytes, little endian.
+ */
+extern const ListCodec LIST_CODEC_INT;
+
+/**
+ * @brief Codec for C string elements: 4 byte little endian length followed
+ * by the bytes and the terminator, so mapped strings can be used in place.
+ */
+extern const ListCodec LIST_CODEC_STR;
+
+/**
+ * @brief Save the list to a file in a compact binary format.
+ * The file starts with a 24 byte header (magic "LABL", format version, codec
+ * tag, flags and element count) followed by the encoded elements back to
+ * back. For codecs without a fixed_size an index of 8 byte element offsets
+ * is appended so list_map_file() can reach any element directly.
+ * Output is assembled in a 1 MiB buffer and written in large blocks.
+ * @param list Pointer to the list.
+ * @param path File to create or truncate.
+ * @param codec Element encoding, e.g., &LIST_CODEC_INT.
+ * @return true on success, false on failure.
+ */
+bool list_save(const List *list, const char *path, const ListCodec *codec);
+
+/**
+ * @brief Load a list saved with list_save().
+ * The file is read in large blocks and decoded in place; elements are
+ * allocated by the codec and owned by the caller.
+ * @param path File to read.
+ * @param codec The codec the file was saved with.
+ * @return New list, or NULL on failure (bad header, other codec tag,
+ * truncated file, I/O or allocation error).
+ */
+List *list_load(const char *path, const ListCodec *codec);
+
+/**
+ * @brief Map a file saved with list_save() as a read-only LIST_MAPPED list.
+ * Only the header is checked, so this is O(1) regardless of the file size;
+ * no node or element is allocated and pages are read lazily on first use.
+ * Elements are the codec's views into the mapping and must not be written
+ * or freed, and the file must not change while it is mapped.
+ *
+ * Mapped lists work with list_get(), list_size(), list_is_empty(),
+ * list_iter(), list_to_array(), is_sorted() and as inputs to merge(),
+ * list_merge_k(), list_merge_parallel(), list_select(), list_quantiles()
+ * and list_save(). Operations that modify a list fail on them.
+ * list_destroy() unmaps the file and ignores free_func.
+ * @param path File to map.
+ * @param codec The codec the file was saved with, which must have a view.
+ * @return New mapped list, or NULL on failure.
+ */
+List *list_map_file(const char *path, const ListCodec *codec);
+
+/**
+ * @struct ExternalSortOptions
+ * @brief Settings for list_external_sort().
+ */
+typedef struct {
+    size_t memory_budget;   /**< Approximate bytes of elements held at once, 0 for 64 MiB. */
+    const char *temp_dir;   /**< Directory for run files, NULL for $TMPDIR or /tmp. */
+} ExternalSortOptions;
+
+/**
+ * @brief Sort a list file that may be larger than memory.
+ * The input is streamed into runs of about memory_budget bytes, each run
+ * is sorted in memory and spilled to a temporary file in the list format,
+ * and the runs are k-way merged into out_path. When there are more runs
+ * than the budget has room for read buffers (256 KiB each) they are merged
+ * in several passes. Codecs with view and measure are sorted in place:
+ * a batch is copied into one arena and no element is decoded. The output
+ * is a regular list file that can be loaded with list_load() or mapped
+ * with list_map_file(); temporary files are removed before returning.
+ * The sort is not stable.
+ * @param in_path File written by list_save().
+ * @param out_path File to create or truncate (must differ from in_path).
+ * @param codec The codec of the input file.
+ * @param cmp Compare function.
+ * @param opts Options, or NULL for the defaults.
+ * @return true on success, false on failure.
+ */
+bool list_external_sort(const char *in_path, const char *out_path, const ListCodec *codec,
+                        CompareFunc cmp, const ExternalSortOptions *opts);
+
+/**
+ * @typedef FormatFunc
+ * @brief Write the text of elem into out, which has room for cap bytes.
+ * Returns the length of the text; if that exceeds cap the contents of out
+ * are ignored and the call is repeated with at least that much room.
+ */
+typedef size_t (*FormatFunc)(const void *elem, char *out, size_t cap);
+
+/**
+ * @brief Format an int element in decimal.
+ */
+size_t list_format_int(const void *elem, char *out, size_t cap);
+
+/**
+ * @brief Format a C string element as is.
+ */
+size_t list_format_str(const void *elem, char *out, size_t cap);
+
+/**
+ * @brief Write the elements as text, one per line, in a single pass.
+ * Elements are formatted straight into a 1 MiB buffer that is flushed with
+ * write(), so output costs one system call per buffer rather than per line.
+ * fd is left open; flush any stdio buffering on it first.
+ * @param list Pointer to the list.
+ * @param fd File descriptor to write to.
+ * @param format Formatter, e.g., list_format_int.
+ * @return true on success, false on failure.
+ */
+bool list_write(const List *list, int fd, FormatFunc format);
+
+/* === Parallel operations === */
+
+/**
+ * @brief Merge two sorted lists into a new sorted list using several threads.
+ * The output is split into equal pieces with a co-rank (merge path) binary
+ * search, each piece is merged concurrently and the node chains are stitched
+ * together. The result is identical to merge(), including the order of ties
+ * and the list type: two LIST_COMPACT or two LIST_XOR inputs are merged by
+ * merge() on the calling thread, any other pair gives a linked list.
+ * @param list1 First sorted list.
+ * @param list2 Second sorted list.
+ * @param cmp Compare function the inputs are sorted by.
+ * @param nthreads Number of threads to use, 0 for one per online CPU.
+ * @return New list sharing the data pointers of the inputs, or NULL on failure.
+ */
+List *list_merge_parallel(const List *list1, const List *list2, CompareFunc cmp, size_t nthreads);
+
+/**
+ * @brief Destroy the list, freeing elements and nodes on several threads.
+ * The node chain is partitioned into contiguous segments and each thread
+ * frees the elements of its own segment; the nodes are then handed back a
+ * slab at a time. free_func must be safe to call from multiple threads at
+ * once (free() is).
+ * @param list Pointer to the list to destroy.
+ * @param free_func Function to free individual elements. If NULL, elements are not freed.
+ * @param nthreads Number of threads to use, 0 for one per online CPU.
+ */
+void list_destroy_parallel(List *list, FreeFunc free_func, size_t nthreads);
+
+/**
+ * @brief Check if the list is sorted according to cmp using several threads.
+ * The chain is split into segments that are checked concurrently, each
+ * including the pair that crosses into the next segment. All threads stop
+ * soon after any of them finds a violation.
+ * @param list Pointer to the list.
+ * @param cmp Compare function.
+ * @param nthreads Number of threads to use, 0 for one per online CPU.
+ * @return true if the list is sorted, false otherwise.
+ */
+bool list_is_sorted_parallel(const List *list, CompareFunc cmp, size_t nthreads);
+
 #endif // LAB_H
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "lab_internal.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Strings are packed into chunks of this size; larger ones get their own
+#define ARENA_CHUNK_BYTES ((size_t)1 << 20)
+
+// First size of the interning table, it doubles at half load
+#define ARENA_TABLE_MIN 1024
+
+typedef struct ArenaChunk {
+    struct ArenaChunk *next;
+    size_t used;
+    size_t cap;
+    uint64_t data[];    // records, each 8 byte aligned
+} ArenaChunk;
+
+struct StringArena {
+    atomic_size_t refs;
+    ArenaChunk *chunks;     // the one strings are added to comes first
+    const char **table;     // open addressing set of interned strings
+    size_t table_cap;
+    size_t count;
+    bool intern;
+};
+
+/* === Arena lifetime === */
+
+/**
+ * @brief Create an empty string arena.
+ */
+StringArena *string_arena_create(bool intern) {
+    StringArena *arena = calloc(1, sizeof(StringArena));
+    if (!arena) return NULL;
+    atomic_init(&arena->refs, 1);
+    arena->intern = intern;
+    return arena;
+}
+
+/**
+ * @brief Drop one reference, freeing every string on the last one.
+ */
+void string_arena_release(StringArena *arena) {
+    if (!arena) return;
+    if (atomic_fetch_sub_explicit(&arena->refs, 1, memory_order_acq_rel) != 1) return;
+
+    ArenaChunk *chunk = arena->chunks;
+    while (chunk) {
+        ArenaChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(arena->table);
+    free(arena);
+}
+
+/**
+ * @brief Let the list hold a reference to the arena.
+ */
+bool list_attach_arena(List *list, StringArena *arena) {
+    if (!list || !arena || list->arena) return false;
+    atomic_fetch_add_explicit(&arena->refs, 1, memory_order_relaxed);
+    list->arena = arena;
+    return true;
+}
+
+/* === Adding strings === */
+
+/**
+ * @brief Byte-wise hash (FNV-1a) of len bytes.
+ */
+static uint64_t hash_bytes(const char *s, size_t len) {
+    uint64_t h = UINT64_C(0xcbf29ce484222325);
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ (unsigned char)s[i]) * UINT64_C(0x100000001b3);
+    }
+    return h;
+}
+
+/**
+ * @brief Find the interned copy of s, or the empty slot it would go in.
+ * Stored strings can be shorter than s, so the compare stops at their end.
+ */
+static const char **table_slot(const StringArena *arena, const char *s, size_t len) {
+    size_t mask = arena->table_cap - 1;
+    size_t i = (size_t)hash_bytes(s, len) & mask;
+    while (arena->table[i] &&
+           (strncmp(arena->table[i], s, len) != 0 || arena->table[i][len] != '\0')) {
+        i = (i + 1) & mask;
+    }
+    return &arena->table[i];
+}
+
+/**
+ * @brief Double the interning table (or create it) and rehash.
+ */
+static bool table_grow(StringArena *arena) {
+    size_t cap = arena->table_cap ? arena->table_cap * 2 : ARENA_TABLE_MIN;
+    const char **old = arena->table;
+    size_t old_cap = arena->table_cap;
+    arena->table = calloc(cap, sizeof(const char *));
+    if (!arena->table) {
+        arena->table = old;
+        return false;
+    }
+    arena->table_cap = cap;
+    for (size_t i = 0; i < old_cap; i++) {
+        if (old[i]) {
+            *table_slot(arena, old[i], strlen(old[i])) = old[i];
+        }
+    }
+    free(old);
+    return true;
+}
+
+/**
+ * @brief Claim bytes (a multiple of 8) of chunk space.
+ */
+static uint64_t *arena_alloc(StringArena *arena, size_t bytes) {
+    ArenaChunk *chunk = arena->chunks;
+    if (chunk && chunk->cap - chunk->used >= bytes) {
+        uint64_t *out = chunk->data + chunk->used / 8;
+        chunk->used += bytes;
+        return out;
+    }
+
+    // Oversized strings go behind the current chunk so it keeps filling up
+    size_t cap = bytes > ARENA_CHUNK_BYTES / 4 ? bytes : ARENA_CHUNK_BYTES;
+    ArenaChunk *fresh = malloc(sizeof(ArenaChunk) + cap);
+    if (!fresh) return NULL;
+    fresh->used = bytes;
+    fresh->cap = cap;
+    if (cap == bytes && chunk) {
+        fresh->next = chunk->next;
+        chunk->next = fresh;
+    } else {
+        fresh->next = chunk;
+        arena->chunks = fresh;
+    }
+    return fresh->data;
+}
+
+/**
+ * @brief Copy a string into the arena behind its cached prefix.
+ */
+const char *string_arena_add(StringArena *arena, const char *s, size_t len) {
+    if (!arena || (!s && len > 0)) return NULL;
+
+    const char **slot = NULL;
+    if (arena->intern) {
+        if (arena->count * 2 >= arena->table_cap && !table_grow(arena)) return NULL;
+        slot = table_slot(arena, s, len);
+        if (*slot) return *slot;
+    }
+
+    // Record: 8 byte prefix, the bytes, the terminator, padding to 8
+    uint64_t *record = arena_alloc(arena, 8 + ((len + 8) & ~(size_t)7));
+    if (!record) return NULL;
+    char *copy = (char *)(record + 1);
+    memcpy(copy, s, len);
+    memset(copy + len, 0, 8 - (len & 7));
+
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < 8; i++) {
+        prefix = prefix << 8 | (unsigned char)copy[i < len ? i : len];
+    }
+    *record = prefix;
+
+    if (slot) {
+        *slot = copy;
+    }
+    arena->count++;
+    return copy;
+}
+
+/* === Comparison === */
+
+/**
+ * @brief Compare two arena strings in strcmp order, see lab_arena_strcmp().
+ */
+int compare_arena_str(const void *a, const void *b) {
+    return lab_arena_strcmp((const char *)a, (const char *)b);
+}
@@ -0,0 +1,144 @@
+#include "lab_internal.h"
+#include <stdlib.h>
+
+// Slots of a new pool, including the sentinel; it doubles when full
+#define COMPACT_MIN_SLOTS 16
+
+// Links are 32 bit and slot 0 is the sentinel
+#define COMPACT_MAX_SLOTS UINT32_MAX
+
+/* === Pool === */
+
+/**
+ * @brief Set up an empty pool holding only the sentinel.
+ */
+bool lab_compact_init(CompactPool *pool) {
+    pool->nodes = malloc(sizeof(CompactNode) * COMPACT_MIN_SLOTS);
+    if (!pool->nodes) return false;
+    pool->nodes[0] = (CompactNode){ NULL, 0, 0 };
+    pool->used = 1;
+    pool->cap = COMPACT_MIN_SLOTS;
+    pool->free_head = 0;
+    return true;
+}
+
+/**
+ * @brief Free the element of every linked node (if free_func is set) and
+ * the pool itself.
+ */
+void lab_compact_release(CompactPool *pool, FreeFunc free_func) {
+    if (!pool->nodes) return;
+    if (free_func) {
+        for (uint32_t i = pool->nodes[0].next; i != 0; i = pool->nodes[i].next) {
+            if (pool->nodes[i].data) {
+                free_func(pool->nodes[i].data);
+            }
+        }
+    }
+    free(pool->nodes);
+    *pool = (CompactPool){ 0 };
+}
+
+/**
+ * @brief Take a slot, reusing a freed one if possible.
+ * The node array may move, so callers hold indices rather than pointers.
+ * @return The slot index, or 0 on failure.
+ */
+static uint32_t compact_alloc(CompactPool *pool) {
+    if (pool->free_head != 0) {
+        uint32_t slot = pool->free_head;
+        pool->free_head = pool->nodes[slot].next;
+        return slot;
+    }
+    if (pool->used == pool->cap) {
+        if (pool->cap == COMPACT_MAX_SLOTS) return 0;
+        uint32_t cap = pool->cap > COMPACT_MAX_SLOTS / 2 ? COMPACT_MAX_SLOTS : pool->cap * 2;
+        CompactNode *nodes = realloc(pool->nodes, sizeof(CompactNode) * cap);
+        if (!nodes) return 0;
+        pool->nodes = nodes;
+        pool->cap = cap;
+    }
+    return pool->used++;
+}
+
+/**
+ * @brief Slot of the element at index, index == size gives the sentinel.
+ * Walks from whichever end is closer.
+ */
+static uint32_t compact_at(const List *list, size_t index) {
+    const CompactNode *nodes = list->compact.nodes;
+    uint32_t cur = 0;
+    if (index < list->size / 2) {
+        for (size_t i = 0; i <= index; i++) {
+            cur = nodes[cur].next;
+        }
+    } else {
+        for (size_t i = list->size; i > index; i--) {
+            cur = nodes[cur].prev;
+        }
+    }
+    return cur;
+}
+
+/* === Element access === */
+
+/**
+ * @brief Insert n elements so that the first of them ends up at index.
+ */
+bool lab_compact_insert(List *list, size_t index, void *const *items, size_t n) {
+    CompactPool *pool = &list->compact;
+    if (n > COMPACT_MAX_SLOTS - list->size - 1) return false;
+
+    // Slots are taken first so a failure leaves the list unchanged
+    uint32_t one;
+    uint32_t *slots = n == 1 ? &one : malloc(sizeof(uint32_t) * n);
+    if (!slots) return false;
+    for (size_t i = 0; i < n; i++) {
+        slots[i] = compact_alloc(pool);
+        if (slots[i] == 0) {
+            while (i-- > 0) {
+                pool->nodes[slots[i]].next = pool->free_head;
+                pool->free_head = slots[i];
+            }
+            if (slots != &one) free(slots);
+            return false;
+        }
+    }
+
+    CompactNode *nodes = pool->nodes;
+    uint32_t after = compact_at(list, index);
+    uint32_t before = nodes[after].prev;
+    for (size_t i = 0; i < n; i++) {
+        nodes[slots[i]] = (CompactNode){ items[i], after, before };
+        nodes[before].next = slots[i];
+        nodes[after].prev = slots[i];
+        before = slots[i];
+    }
+    list->size += n;
+
+    if (slots != &one) free(slots);
+    return true;
+}
+
+/**
+ * @brief Unlink the element at index and give its slot back.
+ */
+void *lab_compact_remove(List *list, size_t index) {
+    CompactNode *nodes = list->compact.nodes;
+    uint32_t slot = compact_at(list, index);
+    void *data = nodes[slot].data;
+    nodes[nodes[slot].prev].next = nodes[slot].next;
+    nodes[nodes[slot].next].prev = nodes[slot].prev;
+
+    nodes[slot] = (CompactNode){ NULL, list->compact.free_head, 0 };
+    list->compact.free_head = slot;
+    list->size--;
+    return data;
+}
+
+/**
+ * @brief Element at index, which must be below size.
+ */
+void *lab_compact_get(const List *list, size_t index) {
+    return list->compact.nodes[compact_at(list, index)].data;
+}
@@ -0,0 +1,391 @@
+#ifndef LAB_INTERNAL_H
+#define LAB_INTERNAL_H
+
+#include "lab.h"
+#include <stdatomic.h>
+#include <string.h>
+
+/**
+ * @file lab_internal.h
+ * @brief Private definitions shared by the list implementation files.
+ * Nothing in here is part of the public API declared in lab.h.
+ */
+
+/**
+ * @brief structure for the doubly linked list
+ */
+typedef struct Node {
+    void *data;
+    struct Node *next;
+    struct Node *prev;
+} Node;
+
+/**
+ * @brief Block of nodes allocated at once.
+ * A slab is shared by every list that holds nodes carved from it and is
+ * freed when the last of those lists lets go of it.
+ */
+typedef struct NodeSlab {
+    atomic_size_t refs;
+    size_t count;
+    Node nodes[];
+} NodeSlab;
+
+/**
+ * @brief Node allocator owned by a list.
+ * Nodes are carved from slabs instead of being malloc'd one by one, removed
+ * nodes are kept on a free list for reuse, and destroying the list releases
+ * whole slabs. Lists that exchange nodes (split, splice, partition) share
+ * references to the slabs involved.
+ */
+typedef struct {
+    NodeSlab **slabs;   // referenced slabs, sorted by address
+    size_t slab_count;
+    size_t slab_cap;
+    Node *free_nodes;   // singly linked through next
+    Node *bump;         // unused tail of the newest slab
+    size_t bump_left;
+    size_t grow;        // node count of the next slab
+    size_t stride;      // bytes per node, more than sizeof(Node) for inline values
+} NodePool;
+
+/**
+ * @brief The node i strides after node in a block from pool_alloc().
+ */
+static inline Node *pool_node(const NodePool *pool, Node *node, size_t i) {
+    return (Node *)((char *)node + i * pool->stride);
+}
+
+/**
+ * @brief Storage of an inline value, right behind its node.
+ */
+static inline void *node_value(Node *node) {
+    return node + 1;
+}
+
+/**
+ * @brief Read-only view of a mapped list file, see list_map_file().
+ * Elements are either stride bytes apart from the end of the header or
+ * located through the offset index at the end of the file.
+ */
+typedef struct {
+    const unsigned char *base;  // start of the mapping
+    size_t bytes;
+    size_t stride;              // fixed element width, 0 when indexed
+    const unsigned char *offsets;   // little endian u64 per element
+    size_t data_end;            // elements must start below this offset
+    const void *(*view)(const unsigned char *in);
+} MappedView;
+
+/**
+ * @brief Node of a LIST_COMPACT list, linked by slot index.
+ */
+typedef struct {
+    void *data;
+    uint32_t next;
+    uint32_t prev;
+} CompactNode;
+
+/**
+ * @brief Growable array of CompactNodes; slot 0 is the sentinel.
+ * Indices survive the array being reallocated, and freed slots are kept on
+ * a list threaded through next for reuse.
+ */
+typedef struct {
+    CompactNode *nodes;
+    uint32_t used;      // slots handed out so far, including the sentinel
+    uint32_t cap;
+    uint32_t free_head; // 0 when no freed slot is waiting
+} CompactPool;
+
+/**
+ * @brief Node of a LIST_XOR list: one link field holding the address of the
+ * previous node XOR the address of the next one.
+ */
+typedef struct XorNode {
+    void *data;
+    uintptr_t link;
+} XorNode;
+
+/**
+ * @brief Block of XorNodes allocated at once, freed when the list goes.
+ */
+typedef struct XorBlock {
+    struct XorBlock *next;
+    XorNode nodes[];
+} XorBlock;
+
+/**
+ * @brief Node storage and ends of a LIST_XOR list.
+ * The sentinel's link is first XOR last, so walking in either direction only
+ * needs a pair of neighbouring nodes to start from; first provides that.
+ */
+typedef struct {
+    XorNode sentinel;
+    XorNode *first;     // the sentinel itself when empty
+    XorBlock *blocks;
+    XorNode *free_nodes;    // singly linked through link
+    XorNode *bump;      // unused tail of the newest block
+    size_t bump_left;
+    size_t grow;        // node count of the next block
+} XorPool;
+
+/**
+ * @brief The neighbour of node on the other side from the one given.
+ */
+static inline XorNode *xor_step(const XorNode *node, const XorNode *from) {
+    return (XorNode *)(node->link ^ (uintptr_t)from);
+}
+
+/**
+ * @brief structure containing the sentinel node and metadata
+ */
+struct List {
+    Node *sentinel;
+    size_t size;
+    ListType type;
+    NodePool pool;
+    SortOptions sort_opts;
+    void *scratch;      // spill buffer kept between sorts when reuse_scratch is set
+    size_t scratch_bytes;
+    MappedView map;     // LIST_MAPPED only, the node chain is then empty
+    StringArena *arena; // released by list_destroy(), see list_attach_arena()
+    size_t value_size;  // bytes stored in each node, 0 when nodes hold pointers
+    CompactPool compact;    // LIST_COMPACT only, the node chain is then empty
+    XorPool xor_pool;   // LIST_XOR only, the node chain is then empty
+};
+
+/**
+ * @brief Whether the list keeps its elements in its own node chain.
+ * Other representations (LIST_MAPPED, LIST_COMPACT, LIST_XOR) are read through
+ * list_iter() and list_get(), and everything that edits the chain refuses
+ * them unless it has a branch of its own for them.
+ */
+static inline bool list_has_chain(const List *list) {
+    return list->type == LIST_LINKED_SENTINEL;
+}
+
+/**
+ * @brief List type of a merge result: inputs that are both LIST_COMPACT or
+ * both LIST_XOR keep their smaller nodes, anything else gives a linked list.
+ */
+static inline ListType lab_merge_type(const List *a, const List *b) {
+    if (a->type == b->type && (a->type == LIST_COMPACT || a->type == LIST_XOR)) {
+        return a->type;
+    }
+    return LIST_LINKED_SENTINEL;
+}
+
+/**
+ * @brief Allocate n contiguous unlinked nodes, pool->stride bytes apart.
+ * @return The first of the nodes, or NULL on failure.
+ */
+Node *pool_alloc(NodePool *pool, size_t n);
+
+/**
+ * @brief Allocate a single node, reusing a freed one if possible.
+ * @return The node, or NULL on failure.
+ */
+Node *pool_alloc_one(NodePool *pool);
+
+/**
+ * @brief Give an unlinked node back for reuse by the same list.
+ */
+void pool_free_one(NodePool *pool, Node *node);
+
+/**
+ * @brief Make dst hold a reference to every slab src holds.
+ * Used when nodes are copied by reference into dst (split, partition).
+ * @return true on success, false on failure (dst is unchanged).
+ */
+bool pool_share(NodePool *dst, const NodePool *src);
+
+/**
+ * @brief Move every slab reference from src into dst.
+ * src gives up its free list as well, so it must not own any linked nodes.
+ * @return true on success, false on failure (both are unchanged).
+ */
+bool pool_take(NodePool *dst, NodePool *src);
+
+/**
+ * @brief Drop every slab reference, freeing slabs no other list uses.
+ */
+void pool_release(NodePool *pool);
+
+/**
+ * @brief Cached prefix of a StringArena string.
+ * The 8 bytes before each string hold its first 8 bytes as an integer whose
+ * most significant byte is the first one, zero padded, so differing
+ * prefixes decide the strcmp order alone.
+ */
+static inline uint64_t lab_arena_prefix(const char *s) {
+    uint64_t prefix;
+    memcpy(&prefix, s - 8, sizeof(prefix));
+    return prefix;
+}
+
+/**
+ * @brief strcmp for StringArena strings that share prefix.
+ * Equal prefixes with a zero last byte mean both strings ended inside them.
+ */
+static inline int lab_arena_strcmp_tail(const char *a, const char *b, uint64_t prefix) {
+    if ((prefix & 0xff) == 0) return 0;
+    return strcmp(a + 8, b + 8);
+}
+
+/**
+ * @brief strcmp for StringArena strings, deciding on the prefixes first.
+ */
+static inline int lab_arena_strcmp(const char *a, const char *b) {
+    uint64_t pa = lab_arena_prefix(a);
+    uint64_t pb = lab_arena_prefix(b);
+    if (pa != pb) return pa < pb ? -1 : 1;
+    return lab_arena_strcmp_tail(a, b, pa);
+}
+
+/**
+ * @brief Make out share the slabs of in if in stores inline values, so
+ * that element pointers copied from in stay valid as long as out lives.
+ * @return true on success, false on failure.
+ */
+bool lab_share_values(List *out, const List *in);
+
+/**
+ * @brief Element index of a LIST_MAPPED list, index must be below size.
+ * @return The element, or NULL if the file's index points outside the data.
+ */
+void *lab_mapped_get(const List *list, size_t index);
+
+/**
+ * @brief Unmap the file behind a LIST_MAPPED list.
+ */
+void lab_unmap(MappedView *map);
+
+/**
+ * @brief Set up the pool of a LIST_COMPACT list with just its sentinel.
+ * @return false on allocation failure.
+ */
+bool lab_compact_init(CompactPool *pool);
+
+/**
+ * @brief Free the elements (if free_func is set) and the pool.
+ */
+void lab_compact_release(CompactPool *pool, FreeFunc free_func);
+
+/**
+ * @brief Insert n (> 0) elements of a LIST_COMPACT list at index <= size.
+ * @return true on success, false on failure (the list is unchanged).
+ */
+bool lab_compact_insert(List *list, size_t index, void *const *items, size_t n);
+
+/**
+ * @brief Remove the element at index < size of a LIST_COMPACT list.
+ * @return The element.
+ */
+void *lab_compact_remove(List *list, size_t index);
+
+/**
+ * @brief Element at index < size of a LIST_COMPACT list.
+ */
+void *lab_compact_get(const List *list, size_t index);
+
+/**
+ * @brief Set up the nodes of an empty LIST_XOR list.
+ * The sentinel points into the List, so this runs once the List has its
+ * final address.
+ */
+void lab_xor_init(XorPool *pool);
+
+/**
+ * @brief Free the elements (if free_func is set) and the nodes.
+ */
+void lab_xor_release(XorPool *pool, FreeFunc free_func);
+
+/**
+ * @brief Insert n (> 0) elements of a LIST_XOR list at index <= size.
+ * @return true on success, false on failure (the list is unchanged).
+ */
+bool lab_xor_insert(List *list, size_t index, void *const *items, size_t n);
+
+/**
+ * @brief Remove the element at index < size of a LIST_XOR list.
+ * @return The element.
+ */
+void *lab_xor_remove(List *list, size_t index);
+
+/**
+ * @brief Element at index < size of a LIST_XOR list.
+ */
+void *lab_xor_get(const List *list, size_t index);
+
+/**
+ * @brief Context that lets a plain CompareFunc run where a CompareFuncCtx
+ * is expected; pass lab_plain_compare with a pointer to one of these.
+ */
+typedef struct {
+    CompareFunc cmp;
+} PlainCompare;
+
+/**
+ * @brief CompareFuncCtx that forwards to the PlainCompare in ctx.
+ */
+int lab_plain_compare(const void *a, const void *b, void *ctx);
+
+/**
+ * @brief Sort an array of element pointers with introsort (not stable).
+ */
+void lab_introsort(void **items, size_t n, CompareFuncCtx cmp, void *ctx);
+
+/**
+ * @brief Sort an array of element pointers (not stable).
+ * compare_int, compare_str and compare_arena_str get the inlined pdqsorts,
+ * compare_int over copied keys; anything else goes through lab_introsort().
+ */
+void lab_sort_items(void **items, size_t n, CompareFunc cmp);
+
+/**
+ * @brief Sort an array of element pointers stably: equal elements keep
+ * their relative order.
+ * With plain set to compare_int, compare_str or compare_arena_str the keys
+ * are copied next to each element's position and sorted with an inlined
+ * pdqsort; anything else sorts pointers to the array slots with introsort
+ * and breaks ties by slot address.
+ * @param plain The plain compare function behind cmp and ctx, or NULL.
+ * @return false if the key array could not be allocated (items is unchanged).
+ */
+bool lab_stable_sort(void **items, size_t n, CompareFuncCtx cmp, void *ctx, CompareFunc plain);
+
+/**
+ * @brief Rearrange items so that items[k] holds the element a full sort
+ * would put there, with nothing greater before it and nothing smaller after.
+ * Introselect: quickselect with a heapsort fallback, linear expected time.
+ */
+void lab_introselect(void **items, size_t n, size_t k, CompareFuncCtx cmp, void *ctx);
+
+/**
+ * @brief lab_introselect() for several ranks in one partitioning pass.
+ * @param ranks Ranks to place, ascending, each below n.
+ */
+void lab_multiselect(void **items, size_t n, const size_t *ranks, size_t nranks,
+                     CompareFuncCtx cmp, void *ctx);
+
+/**
+ * @brief Resolve a caller supplied thread count.
+ * @param requested Number of threads asked for, 0 means one per online CPU.
+ * @param work Number of independent work items, threads are capped to this.
+ * @return A thread count that is at least 1.
+ */
+size_t lab_thread_count(size_t requested, size_t work);
+
+/**
+ * @brief Run fn over nthreads argument blocks and wait for all of them.
+ * The last block runs on the calling thread, as does any block whose thread
+ * could not be created, so every block is always processed.
+ * @param nthreads Number of argument blocks.
+ * @param fn Worker function.
+ * @param args Base of an array of argument blocks.
+ * @param stride Size in bytes of one argument block.
+ */
+void lab_parallel_run(size_t nthreads, void *(*fn)(void *), void *args, size_t stride);
+
+#endif // LAB_INTERNAL_H
@@ -0,0 +1,928 @@
+#include "lab_internal.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* === File format === */
+
+// Header: magic, version, codec tag, flags, element count (little endian)
+#define LIST_FILE_MAGIC "LABL"
+#define LIST_FILE_VERSION 1u
+#define LIST_HEADER_BYTES 24
+
+// The file ends with one u64 offset per element
+#define LIST_FLAG_INDEX 1u
+
+// Reads and writes go through buffers of this size
+#define IO_BUFFER_BYTES ((size_t)1 << 20)
+
+static inline void put_u32(unsigned char *p, uint32_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+static inline uint32_t get_u32(const unsigned char *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static inline void put_u64(unsigned char *p, uint64_t v) {
+    put_u32(p, (uint32_t)v);
+    put_u32(p + 4, (uint32_t)(v >> 32));
+}
+
+static inline uint64_t get_u64(const unsigned char *p) {
+    return (uint64_t)get_u32(p) | (uint64_t)get_u32(p + 4) << 32;
+}
+
+/* === Built-in codecs === */
+
+static size_t int_size(const void *elem) {
+    (void)elem;
+    return 4;
+}
+
+static void int_encode(const void *elem, unsigned char *out) {
+    put_u32(out, (uint32_t)*(const int *)elem);
+}
+
+static size_t int_decode(const unsigned char *in, size_t avail, void **elem) {
+    if (avail < 4) return 0;
+    int *val = malloc(sizeof(int));
+    if (!val) return LIST_CODEC_ERROR;
+    *val = (int)get_u32(in);
+    *elem = val;
+    return 4;
+}
+
+static const void *int_view(const unsigned char *in) {
+    return in;
+}
+
+static size_t int_measure(const unsigned char *in, size_t avail) {
+    (void)in;
+    return avail < 4 ? 0 : 4;
+}
+
+static size_t str_size(const void *elem) {
+    return 4 + strlen((const char *)elem) + 1;
+}
+
+static void str_encode(const void *elem, unsigned char *out) {
+    size_t len = strlen((const char *)elem);
+    put_u32(out, (uint32_t)len);
+    memcpy(out + 4, elem, len + 1);
+}
+
+static size_t str_decode(const unsigned char *in, size_t avail, void **elem) {
+    if (avail < 4) return 0;
+    size_t len = get_u32(in);
+    if (avail - 4 <= len) return 0;
+    if (in[4 + len] != '\0') return LIST_CODEC_ERROR;
+    char *s = malloc(len + 1);
+    if (!s) return LIST_CODEC_ERROR;
+    memcpy(s, in + 4, len + 1);
+    *elem = s;
+    return 4 + len + 1;
+}
+
+static const void *str_view(const unsigned char *in) {
+    return in + 4;
+}
+
+static size_t str_measure(const unsigned char *in, size_t avail) {
+    if (avail < 4) return 0;
+    size_t len = get_u32(in);
+    if (avail - 4 <= len) return 0;
+    return in[4 + len] == '\0' ? 4 + len + 1 : LIST_CODEC_ERROR;
+}
+
+const ListCodec LIST_CODEC_INT = {
+    .tag = 1, .encoded_size = int_size, .encode = int_encode, .decode = int_decode,
+    .free_elem = free, .fixed_size = 4, .view = int_view, .measure = int_measure,
+};
+const ListCodec LIST_CODEC_STR = {
+    .tag = 2, .encoded_size = str_size, .encode = str_encode, .decode = str_decode,
+    .free_elem = free, .fixed_size = 0, .view = str_view, .measure = str_measure,
+};
+
+/* === Buffered writer === */
+
+typedef struct {
+    int fd;
+    unsigned char *buf;
+    size_t len;
+    size_t cap;
+} Writer;
+
+/**
+ * @brief Take over an open file descriptor for buffered writing.
+ * @return false if the buffer cannot be allocated (fd is closed then).
+ */
+static bool writer_init(Writer *w, int fd) {
+    *w = (Writer){ fd, malloc(IO_BUFFER_BYTES), 0, IO_BUFFER_BYTES };
+    if (w->buf == NULL) {
+        close(fd);
+        return false;
+    }
+    return true;
+}
+
+static bool writer_flush(Writer *w) {
+    size_t done = 0;
+    while (done < w->len) {
+        ssize_t n = write(w->fd, w->buf + done, w->len - done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        done += (size_t)n;
+    }
+    w->len = 0;
+    return true;
+}
+
+/**
+ * @brief Flush, close the file and free the buffer.
+ * @return ok, cleared if anything failed on the way.
+ */
+static bool writer_finish(Writer *w, bool ok) {
+    ok = ok && writer_flush(w);
+    ok = close(w->fd) == 0 && ok;
+    free(w->buf);
+    return ok;
+}
+
+/**
+ * @brief Make sure n more bytes fit, flushing or growing the buffer.
+ * @return false on failure.
+ */
+static bool writer_room(Writer *w, size_t n) {
+    if (w->cap - w->len < n) {
+        if (!writer_flush(w)) return false;
+        if (w->cap < n) {
+            unsigned char *buf = realloc(w->buf, n);
+            if (!buf) return false;
+            w->buf = buf;
+            w->cap = n;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Make room for n more bytes and claim them.
+ * @return Where to write them, or NULL on failure.
+ */
+static unsigned char *writer_reserve(Writer *w, size_t n) {
+    if (!writer_room(w, n)) return NULL;
+    unsigned char *out = w->buf + w->len;
+    w->len += n;
+    return out;
+}
+
+static bool write_header(Writer *w, const ListCodec *codec, uint32_t flags, uint64_t count) {
+    unsigned char *header = writer_reserve(w, LIST_HEADER_BYTES);
+    if (!header) return false;
+    memcpy(header, LIST_FILE_MAGIC, 4);
+    put_u32(header + 4, LIST_FILE_VERSION);
+    put_u32(header + 8, codec->tag);
+    put_u32(header + 12, flags);
+    put_u64(header + 16, count);
+    return true;
+}
+
+/**
+ * @brief Encode one element.
+ * @return Bytes written, or 0 on failure.
+ */
+static size_t write_elem(Writer *w, const ListCodec *codec, const void *elem) {
+    size_t n = codec->encoded_size(elem);
+    unsigned char *out = writer_reserve(w, n);
+    if (!out) return 0;
+    codec->encode(elem, out);
+    return n;
+}
+
+/**
+ * @brief Pad the data so that the offset index that follows is 8 byte aligned.
+ */
+static bool write_index_pad(Writer *w, uint64_t data_end) {
+    size_t pad = (size_t)(-data_end & 7);
+    unsigned char *out = writer_reserve(w, pad);
+    if (!out) return false;
+    memset(out, 0, pad);
+    return true;
+}
+
+static bool write_u64(Writer *w, uint64_t v) {
+    unsigned char *out = writer_reserve(w, 8);
+    if (!out) return false;
+    put_u64(out, v);
+    return true;
+}
+
+/**
+ * @brief Save the list to a file in the binary list format.
+ */
+bool list_save(const List *list, const char *path, const ListCodec *codec) {
+    if (!list || !path || !codec) return false;
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    Writer w;
+    if (fd < 0 || !writer_init(&w, fd)) return false;
+
+    bool indexed = codec->fixed_size == 0;
+    bool ok = write_header(&w, codec, indexed ? LIST_FLAG_INDEX : 0, list->size);
+
+    uint64_t offset = LIST_HEADER_BYTES;
+    ListIter it = list_iter(list);
+    void *elem;
+    while (ok && list_next(&it, &elem)) {
+        size_t n = write_elem(&w, codec, elem);
+        offset += n;
+        ok = n > 0;
+    }
+
+    // Second walk for the index
+    if (ok && indexed) {
+        ok = write_index_pad(&w, offset);
+        offset = LIST_HEADER_BYTES;
+        it = list_iter(list);
+        while (ok && list_next(&it, &elem)) {
+            ok = write_u64(&w, offset);
+            offset += codec->encoded_size(elem);
+        }
+    }
+    return writer_finish(&w, ok);
+}
+
+/* === Text output === */
+
+// Two ASCII digits for each value below 100
+static const char DIGIT_PAIRS[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/**
+ * @brief Format an int element in decimal, two digits per division.
+ */
+size_t list_format_int(const void *elem, char *out, size_t cap) {
+    int v = *(const int *)elem;
+    uint32_t u = v < 0 ? 0u - (uint32_t)v : (uint32_t)v;
+    char text[11];
+    char *p = text + sizeof(text);
+
+    while (u >= 100) {
+        p -= 2;
+        memcpy(p, DIGIT_PAIRS + (u % 100) * 2, 2);
+        u /= 100;
+    }
+    if (u >= 10) {
+        p -= 2;
+        memcpy(p, DIGIT_PAIRS + u * 2, 2);
+    } else {
+        *--p = (char)('0' + u);
+    }
+    if (v < 0) {
+        *--p = '-';
+    }
+
+    size_t n = (size_t)(text + sizeof(text) - p);
+    if (n <= cap) {
+        memcpy(out, p, n);
+    }
+    return n;
+}
+
+/**
+ * @brief Format a C string element as is.
+ */
+size_t list_format_str(const void *elem, char *out, size_t cap) {
+    size_t n = strlen((const char *)elem);
+    if (n <= cap) {
+        memcpy(out, elem, n);
+    }
+    return n;
+}
+
+/**
+ * @brief Write the elements as text, one per line, in a single pass.
+ */
+bool list_write(const List *list, int fd, FormatFunc format) {
+    if (!list || fd < 0 || !format) return false;
+
+    // The caller keeps fd, so the writer is not finished with writer_finish()
+    Writer w = { fd, malloc(IO_BUFFER_BYTES), 0, IO_BUFFER_BYTES };
+    bool ok = w.buf != NULL;
+
+    ListIter it = list_iter(list);
+    void *elem;
+    while (ok && list_next(&it, &elem)) {
+        // At least one byte is always free, the newline goes there
+        size_t n = format(elem, (char *)w.buf + w.len, w.cap - w.len - 1);
+        if (n >= w.cap - w.len) {
+            ok = writer_room(&w, n + 1);
+            if (!ok) break;
+            format(elem, (char *)w.buf + w.len, n);
+        }
+        w.buf[w.len + n] = '\n';
+        w.len += n + 1;
+        if (w.len == w.cap) {
+            ok = writer_flush(&w);
+        }
+    }
+
+    ok = ok && writer_flush(&w);
+    free(w.buf);
+    return ok;
+}
+
+/* === Buffered reader === */
+
+typedef struct {
+    int fd;
+    unsigned char *buf;
+    size_t pos;
+    size_t len;
+    size_t cap;
+    bool eof;
+    uint64_t left;      // elements not yet decoded
+} Reader;
+
+/**
+ * @brief Read more input behind the unconsumed bytes.
+ * The buffer doubles when it is full of a single unfinished element.
+ * @return false on a read or allocation error.
+ */
+static bool reader_fill(Reader *r) {
+    if (r->pos > 0) {
+        memmove(r->buf, r->buf + r->pos, r->len - r->pos);
+        r->len -= r->pos;
+        r->pos = 0;
+    }
+    if (r->len == r->cap) {
+        unsigned char *buf = realloc(r->buf, r->cap * 2);
+        if (!buf) return false;
+        r->buf = buf;
+        r->cap *= 2;
+    }
+    for (;;) {
+        ssize_t n = read(r->fd, r->buf + r->len, r->cap - r->len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        r->len += (size_t)n;
+        r->eof = n == 0;
+        return true;
+    }
+}
+
+static void reader_close(Reader *r) {
+    if (r->fd >= 0) {
+        close(r->fd);
+    }
+    free(r->buf);
+    r->fd = -1;
+    r->buf = NULL;
+}
+
+/**
+ * @brief Open a list file and check its header against the codec.
+ * On success r->left holds the element count.
+ */
+static bool reader_open(Reader *r, const char *path, const ListCodec *codec, size_t buffer) {
+    *r = (Reader){ -1, malloc(buffer), 0, 0, buffer, false, 0 };
+    if (r->buf) {
+        r->fd = open(path, O_RDONLY);
+    }
+    bool ok = r->fd >= 0;
+    while (ok && r->len < LIST_HEADER_BYTES && !r->eof) {
+        ok = reader_fill(r);
+    }
+    ok = ok && r->len >= LIST_HEADER_BYTES &&
+         memcmp(r->buf, LIST_FILE_MAGIC, 4) == 0 &&
+         get_u32(r->buf + 4) == LIST_FILE_VERSION &&
+         get_u32(r->buf + 8) == codec->tag;
+    if (!ok) {
+        reader_close(r);
+        return false;
+    }
+    r->left = get_u64(r->buf + 16);
+    r->pos = LIST_HEADER_BYTES;
+    return true;
+}
+
+/**
+ * @brief Decode the next element; r->left must be non-zero.
+ * @return false on truncated or malformed input, I/O or allocation error.
+ */
+static bool reader_next(Reader *r, const ListCodec *codec, void **elem) {
+    for (;;) {
+        size_t used = codec->decode(r->buf + r->pos, r->len - r->pos, elem);
+        if (used == LIST_CODEC_ERROR) return false;
+        if (used > 0) {
+            r->pos += used;
+            r->left--;
+            return true;
+        }
+        // Element continues past the buffered input
+        if (r->eof || !reader_fill(r)) return false;
+    }
+}
+
+/**
+ * @brief Load a list saved with list_save() using the same codec.
+ */
+List *list_load(const char *path, const ListCodec *codec) {
+    if (!path || !codec) return NULL;
+
+    Reader r;
+    if (!reader_open(&r, path, codec, IO_BUFFER_BYTES)) return NULL;
+    List *list = list_create(LIST_LINKED_SENTINEL);
+
+    bool ok = list != NULL;
+    while (ok && r.left > 0) {
+        void *elem = NULL;
+        ok = reader_next(&r, codec, &elem);
+        if (ok && !list_append(list, elem)) {
+            if (codec->free_elem) codec->free_elem(elem);
+            ok = false;
+        }
+    }
+
+    reader_close(&r);
+    if (!ok) {
+        list_destroy(list, codec->free_elem);
+        return NULL;
+    }
+    return list;
+}
+
+/* === Memory mapped lists === */
+
+/**
+ * @brief Map a file saved with list_save() as a read-only list.
+ */
+List *list_map_file(const char *path, const ListCodec *codec) {
+    if (!path || !codec || !codec->view) return NULL;
+
+    // Views hand out the little endian file data as is
+    const uint16_t probe = 1;
+    if (*(const unsigned char *)&probe != 1) return NULL;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < LIST_HEADER_BYTES) {
+        close(fd);
+        return NULL;
+    }
+    size_t bytes = (size_t)st.st_size;
+    void *addr = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) return NULL;
+
+    // Only the header is validated, the elements fault in as they are used
+    const unsigned char *base = addr;
+    MappedView map = { base, bytes, codec->fixed_size, NULL, bytes, codec->view };
+    uint64_t count = get_u64(base + 16);
+    uint32_t flags = get_u32(base + 12);
+    size_t room = bytes - LIST_HEADER_BYTES;
+    bool ok = memcmp(base, LIST_FILE_MAGIC, 4) == 0 &&
+              get_u32(base + 4) == LIST_FILE_VERSION &&
+              get_u32(base + 8) == codec->tag;
+    if (ok && map.stride) {
+        ok = count <= room / map.stride;
+    } else if (ok) {
+        ok = (flags & LIST_FLAG_INDEX) && count <= room / 8;
+        map.data_end = bytes - (size_t)count * 8;
+        map.offsets = base + map.data_end;
+    }
+
+    List *list = ok ? list_create(LIST_LINKED_SENTINEL) : NULL;
+    if (!list) {
+        munmap(addr, bytes);
+        return NULL;
+    }
+    list->type = LIST_MAPPED;
+    list->size = (size_t)count;
+    list->map = map;
+    return list;
+}
+
+/**
+ * @brief Element index of a LIST_MAPPED list.
+ */
+void *lab_mapped_get(const List *list, size_t index) {
+    const MappedView *map = &list->map;
+    uint64_t offset = map->stride ? LIST_HEADER_BYTES + (uint64_t)index * map->stride
+                                  : get_u64(map->offsets + index * 8);
+    if (offset < LIST_HEADER_BYTES || offset >= map->data_end) return NULL;
+    return (void *)map->view(map->base + offset);
+}
+
+/**
+ * @brief Unmap the file behind a LIST_MAPPED list.
+ */
+void lab_unmap(MappedView *map) {
+    if (map->base != NULL) {
+        munmap((void *)map->base, map->bytes);
+        map->base = NULL;
+    }
+}
+
+/* === External merge sort === */
+
+#define EXTSORT_DEFAULT_BUDGET ((size_t)64 << 20)
+
+// Read buffer of each run during a merge; the budget bounds how many are open
+#define MERGE_BUFFER_BYTES ((size_t)256 << 10)
+
+typedef struct {
+    char **paths;
+    size_t count;
+    size_t cap;
+} RunSet;
+
+/**
+ * @brief Create an empty temporary file in dir (NULL: $TMPDIR or /tmp).
+ * @return Its path (caller frees and unlinks), or NULL on failure.
+ */
+static char *temp_create(const char *dir, int *fd) {
+    if (dir == NULL) {
+        dir = getenv("TMPDIR");
+    }
+    if (dir == NULL || *dir == '\0') {
+        dir = "/tmp";
+    }
+    size_t len = strlen(dir) + sizeof("/lab-sort-XXXXXX");
+    char *path = malloc(len);
+    if (!path) return NULL;
+    snprintf(path, len, "%s/lab-sort-XXXXXX", dir);
+    *fd = mkstemp(path);
+    if (*fd < 0) {
+        free(path);
+        return NULL;
+    }
+    return path;
+}
+
+static bool runs_push(RunSet *runs, char *path) {
+    if (runs->count == runs->cap) {
+        size_t cap = runs->cap ? runs->cap * 2 : 16;
+        char **paths = realloc(runs->paths, sizeof(char *) * cap);
+        if (!paths) return false;
+        runs->paths = paths;
+        runs->cap = cap;
+    }
+    runs->paths[runs->count++] = path;
+    return true;
+}
+
+static void runs_clear(RunSet *runs) {
+    for (size_t i = 0; i < runs->count; i++) {
+        unlink(runs->paths[i]);
+        free(runs->paths[i]);
+    }
+    free(runs->paths);
+    *runs = (RunSet){ 0 };
+}
+
+/**
+ * @brief Whether elements can be used straight from their encoded bytes,
+ * which spares the external sort an allocation and a free per element.
+ */
+static bool codec_in_place(const ListCodec *codec) {
+    return codec->view != NULL && codec->measure != NULL;
+}
+
+/**
+ * @brief Buffer the next encoded element without decoding it.
+ * The bytes stay valid until the next read from r.
+ * @return The encoded element, or NULL on truncated or malformed input.
+ */
+static const unsigned char *reader_record(Reader *r, const ListCodec *codec, size_t *size) {
+    for (;;) {
+        size_t n = codec->measure(r->buf + r->pos, r->len - r->pos);
+        if (n == LIST_CODEC_ERROR) return NULL;
+        if (n > 0) {
+            const unsigned char *record = r->buf + r->pos;
+            r->pos += n;
+            r->left--;
+            *size = n;
+            return record;
+        }
+        if (r->eof || !reader_fill(r)) return NULL;
+    }
+}
+
+/**
+ * @brief Next element, viewed in place when the codec allows it and
+ * decoded otherwise. A view stays valid until the next read from r.
+ */
+static bool reader_take(Reader *r, const ListCodec *codec, void **elem) {
+    if (!codec_in_place(codec)) {
+        return reader_next(r, codec, elem);
+    }
+    size_t size;
+    const unsigned char *record = reader_record(r, codec, &size);
+    if (!record) return false;
+    *elem = (void *)codec->view(record);
+    return true;
+}
+
+static void release_elem(const ListCodec *codec, void *elem) {
+    if (elem && !codec_in_place(codec) && codec->free_elem) {
+        codec->free_elem(elem);
+    }
+}
+
+/**
+ * @brief Sort a batch of elements and spill it as a run file.
+ * Decoded elements are freed whether or not this succeeds.
+ */
+static bool write_run(RunSet *runs, void **items, size_t n, const ListCodec *codec,
+                      CompareFunc cmp, const char *dir) {
+    lab_sort_items(items, n, cmp);
+
+    int fd = -1;
+    char *path = temp_create(dir, &fd);
+    Writer w;
+    bool ok = path != NULL && writer_init(&w, fd);
+    if (ok) {
+        ok = write_header(&w, codec, 0, n);
+        for (size_t i = 0; ok && i < n; i++) {
+            ok = write_elem(&w, codec, items[i]) > 0;
+        }
+        ok = writer_finish(&w, ok);
+    }
+    if (path && !runs_push(runs, path)) {
+        unlink(path);
+        free(path);
+        ok = false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        release_elem(codec, items[i]);
+    }
+    return ok;
+}
+
+/**
+ * @brief Pass 1: cut the input into sorted runs of about budget bytes.
+ * With an in-place codec the encoded elements of a batch are copied into
+ * one arena and sorted as views, so nothing is allocated per element.
+ */
+static bool form_runs(Reader *in, const ListCodec *codec, CompareFunc cmp, size_t budget,
+                      const char *dir, RunSet *runs) {
+    bool in_place = codec_in_place(codec);
+    size_t arena_cap = budget;
+    size_t arena_len = 0;
+    unsigned char *arena = in_place ? malloc(arena_cap) : NULL;
+    void **items = NULL;
+    size_t n = 0;
+    size_t cap = 0;
+    size_t used = 0;
+
+    bool ok = !in_place || arena != NULL;
+    while (ok && in->left > 0) {
+        if (n == cap) {
+            size_t grow = cap ? cap * 2 : 1024;
+            void **more = realloc(items, sizeof(void *) * grow);
+            if (!more) {
+                ok = false;
+                break;
+            }
+            items = more;
+            cap = grow;
+        }
+
+        void *elem;
+        size_t size;
+        if (in_place) {
+            const unsigned char *record = reader_record(in, codec, &size);
+            ok = record != NULL;
+            if (ok && arena_cap - arena_len < size) {
+                if (n > 0) {
+                    ok = write_run(runs, items, n, codec, cmp, dir);
+                    n = 0;
+                    used = 0;
+                    arena_len = 0;
+                }
+                // A single element larger than the whole arena
+                if (ok && size > arena_cap) {
+                    unsigned char *bigger = realloc(arena, size);
+                    ok = bigger != NULL;
+                    arena = ok ? bigger : arena;
+                    arena_cap = ok ? size : arena_cap;
+                }
+            }
+            if (!ok) break;
+            memcpy(arena + arena_len, record, size);
+            elem = (void *)codec->view(arena + arena_len);
+            arena_len += size;
+        } else {
+            ok = reader_next(in, codec, &elem);
+            if (!ok) break;
+            size = codec->encoded_size(elem);
+        }
+
+        items[n++] = elem;
+        used += size + sizeof(void *);
+        if (used >= budget) {
+            ok = write_run(runs, items, n, codec, cmp, dir);
+            n = 0;
+            used = 0;
+            arena_len = 0;
+        }
+    }
+
+    // The last partial batch; an empty input still yields one empty run
+    if (ok && (n > 0 || runs->count == 0)) {
+        ok = write_run(runs, items, n, codec, cmp, dir);
+        n = 0;
+    }
+    for (size_t i = 0; i < n; i++) {
+        release_elem(codec, items[i]);
+    }
+    free(items);
+    free(arena);
+    return ok;
+}
+
+typedef struct {
+    Reader reader;
+    void *head;     // current element, released once written out
+} RunCursor;
+
+static void run_sift_down(RunCursor *cur, size_t *heap, size_t count, size_t i, CompareFunc cmp) {
+    for (;;) {
+        size_t best = i;
+        for (size_t c = 2 * i + 1; c <= 2 * i + 2 && c < count; c++) {
+            int r = cmp(cur[heap[c]].head, cur[heap[best]].head);
+            if (r < 0 || (r == 0 && heap[c] < heap[best])) {
+                best = c;
+            }
+        }
+        if (best == i) return;
+        size_t tmp = heap[i];
+        heap[i] = heap[best];
+        heap[best] = tmp;
+        i = best;
+    }
+}
+
+/**
+ * @brief k-way merge run files into the file open at out_fd (closed here).
+ * With indexed set the offset index is staged in another temporary file
+ * and appended, so memory use does not grow with the element count.
+ */
+static bool merge_runs(char *const *paths, size_t n, const ListCodec *codec, CompareFunc cmp,
+                       int out_fd, bool indexed, const char *dir) {
+    RunCursor *cur = calloc(n ? n : 1, sizeof(RunCursor));
+    size_t *heap = malloc(sizeof(size_t) * (n ? n : 1));
+    Writer w;
+    if (!writer_init(&w, out_fd)) {
+        free(heap);
+        free(cur);
+        return false;
+    }
+    bool ok = cur && heap;
+
+    uint64_t total = 0;
+    size_t opened = 0;
+    for (; ok && opened < n; opened++) {
+        ok = reader_open(&cur[opened].reader, paths[opened], codec, MERGE_BUFFER_BYTES);
+        total += ok ? cur[opened].reader.left : 0;
+    }
+
+    int index_fd = -1;
+    char *index_path = NULL;
+    Writer iw;
+    bool iw_open = false;   // iw is only set up once everything before it worked
+    if (ok && indexed) {
+        index_path = temp_create(dir, &index_fd);
+        iw_open = index_path && writer_init(&iw, index_fd);
+        ok = iw_open;
+    }
+    ok = ok && write_header(&w, codec, indexed ? LIST_FLAG_INDEX : 0, total);
+
+    size_t count = 0;
+    for (size_t i = 0; ok && i < n; i++) {
+        if (cur[i].reader.left > 0) {
+            ok = reader_take(&cur[i].reader, codec, &cur[i].head);
+            heap[count++] = i;
+        }
+    }
+    for (size_t i = count / 2; ok && i-- > 0;) {
+        run_sift_down(cur, heap, count, i, cmp);
+    }
+
+    uint64_t offset = LIST_HEADER_BYTES;
+    while (ok && count > 0) {
+        RunCursor *top = &cur[heap[0]];
+        size_t bytes = write_elem(&w, codec, top->head);
+        ok = bytes > 0 && (!indexed || write_u64(&iw, offset));
+        offset += bytes;
+        release_elem(codec, top->head);
+        top->head = NULL;
+
+        if (ok && top->reader.left > 0) {
+            ok = reader_take(&top->reader, codec, &top->head);
+        } else {
+            heap[0] = heap[--count];
+        }
+        // A failed refill leaves a NULL head on top, which must not be compared
+        if (!ok) break;
+        run_sift_down(cur, heap, count, 0, cmp);
+    }
+
+    // Heads still held after a failure
+    for (size_t i = 0; cur && i < n; i++) {
+        release_elem(codec, cur[i].head);
+    }
+    for (size_t i = 0; i < opened; i++) {
+        reader_close(&cur[i].reader);
+    }
+
+    if (iw_open) {
+        ok = writer_finish(&iw, ok) && write_index_pad(&w, offset);
+        // Append the staged index, reading straight into the write buffer
+        int fd = ok ? open(index_path, O_RDONLY) : -1;
+        ok = fd >= 0;
+        while (ok && writer_flush(&w)) {
+            ssize_t got = read(fd, w.buf, w.cap);
+            if (got < 0 && errno == EINTR) continue;
+            ok = got >= 0;
+            if (got <= 0) break;
+            w.len = (size_t)got;
+        }
+        if (fd >= 0) close(fd);
+    }
+    if (index_path) {
+        unlink(index_path);
+        free(index_path);
+    }
+
+    free(heap);
+    free(cur);
+    return writer_finish(&w, ok);
+}
+
+/**
+ * @brief Sort a list file that may be larger than memory.
+ */
+bool list_external_sort(const char *in_path, const char *out_path, const ListCodec *codec,
+                        CompareFunc cmp, const ExternalSortOptions *opts) {
+    if (!in_path || !out_path || !codec || !cmp) return false;
+
+    size_t budget = opts && opts->memory_budget ? opts->memory_budget : EXTSORT_DEFAULT_BUDGET;
+    const char *dir = opts ? opts->temp_dir : NULL;
+    size_t fan_in = budget / MERGE_BUFFER_BYTES;
+    if (fan_in < 2) fan_in = 2;
+
+    Reader in;
+    if (!reader_open(&in, in_path, codec, IO_BUFFER_BYTES)) return false;
+    RunSet runs = { 0 };
+    bool ok = form_runs(&in, codec, cmp, budget, dir, &runs);
+    reader_close(&in);
+
+    // Intermediate passes keep the number of open runs within the budget
+    while (ok && runs.count > fan_in) {
+        RunSet next = { 0 };
+        for (size_t first = 0; ok && first < runs.count; first += fan_in) {
+            size_t group = runs.count - first < fan_in ? runs.count - first : fan_in;
+            int fd = -1;
+            char *path = temp_create(dir, &fd);
+            if (path && !runs_push(&next, path)) {
+                close(fd);
+                unlink(path);
+                free(path);
+                path = NULL;
+            }
+            ok = path && merge_runs(runs.paths + first, group, codec, cmp, fd, false, dir);
+        }
+        runs_clear(&runs);
+        runs = next;
+    }
+
+    // Final pass into the output, indexed like list_save() would write it
+    if (ok) {
+        int fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ok = fd >= 0 && merge_runs(runs.paths, runs.count, codec, cmp, fd,
+                                   codec->fixed_size == 0, dir);
+    }
+    runs_clear(&runs);
+    return ok;
+}
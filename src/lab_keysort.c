@@ -0,0 +1,216 @@
+#include "lab_internal.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* === Key comparators === */
+
+/**
+ * @brief Compare two int32_t keys (ascending).
+ */
+int compare_key_i32(const void *a, const void *b) {
+    int32_t ka;
+    int32_t kb;
+    memcpy(&ka, a, sizeof(ka));
+    memcpy(&kb, b, sizeof(kb));
+    return (ka > kb) - (ka < kb);
+}
+
+/**
+ * @brief Compare two uint32_t keys (ascending).
+ */
+int compare_key_u32(const void *a, const void *b) {
+    uint32_t ka;
+    uint32_t kb;
+    memcpy(&ka, a, sizeof(ka));
+    memcpy(&kb, b, sizeof(kb));
+    return (ka > kb) - (ka < kb);
+}
+
+/**
+ * @brief Compare two int64_t keys (ascending).
+ */
+int compare_key_i64(const void *a, const void *b) {
+    int64_t ka;
+    int64_t kb;
+    memcpy(&ka, a, sizeof(ka));
+    memcpy(&kb, b, sizeof(kb));
+    return (ka > kb) - (ka < kb);
+}
+
+/**
+ * @brief Compare two uint64_t keys (ascending).
+ */
+int compare_key_u64(const void *a, const void *b) {
+    uint64_t ka;
+    uint64_t kb;
+    memcpy(&ka, a, sizeof(ka));
+    memcpy(&kb, b, sizeof(kb));
+    return (ka > kb) - (ka < kb);
+}
+
+/* === LSD radix sort for integer keys === */
+
+typedef struct {
+    uint64_t key;   // key mapped so unsigned order matches key_cmp order
+    size_t index;   // position of the element in the list
+} RadixItem;
+
+/**
+ * @brief Map an integer key to an unsigned value with the same order.
+ * Flipping the sign bit moves negative keys below the positive ones.
+ */
+static uint64_t radix_key(const void *key, CompareFunc key_cmp) {
+    if (key_cmp == compare_key_i32) {
+        uint32_t k;
+        memcpy(&k, key, sizeof(k));
+        return k ^ UINT32_C(0x80000000);
+    }
+    if (key_cmp == compare_key_u32) {
+        uint32_t k;
+        memcpy(&k, key, sizeof(k));
+        return k;
+    }
+    uint64_t k;
+    memcpy(&k, key, sizeof(k));
+    return key_cmp == compare_key_i64 ? k ^ UINT64_C(0x8000000000000000) : k;
+}
+
+/**
+ * @brief Stable LSD radix sort, one byte per pass.
+ * All histograms are taken in a single read pass and bytes on which every
+ * key agrees are skipped.
+ * @return The sorted array, which is either items or tmp.
+ */
+static RadixItem *radix_sort(RadixItem *items, RadixItem *tmp, size_t n, size_t key_bytes) {
+    size_t (*counts)[256] = calloc(key_bytes, sizeof(*counts));
+    if (!counts) return NULL;
+
+    for (size_t i = 0; i < n; i++) {
+        for (size_t b = 0; b < key_bytes; b++) {
+            counts[b][(items[i].key >> (8 * b)) & 0xff]++;
+        }
+    }
+
+    for (size_t b = 0; b < key_bytes; b++) {
+        size_t *count = counts[b];
+        if (count[(items[0].key >> (8 * b)) & 0xff] == n) continue;
+
+        size_t offset = 0;
+        for (size_t d = 0; d < 256; d++) {
+            size_t c = count[d];
+            count[d] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; i++) {
+            tmp[count[(items[i].key >> (8 * b)) & 0xff]++] = items[i];
+        }
+        RadixItem *swap = items;
+        items = tmp;
+        tmp = swap;
+    }
+
+    free(counts);
+    return items;
+}
+
+/* === Sort by extracted key === */
+
+/**
+ * @brief Compare two keys in the key array, breaking ties by position so
+ * the sort is stable.
+ */
+static int compare_key_stable(const void *a, const void *b, void *ctx) {
+    int r = ((const PlainCompare *)ctx)->cmp(a, b);
+    if (r != 0) return r;
+    return ((const char *)a > (const char *)b) - ((const char *)a < (const char *)b);
+}
+
+/**
+ * @brief Whether key_cmp is one of the integer key comparators and
+ * key_size is its width.
+ */
+static bool radix_applies(size_t key_size, CompareFunc key_cmp) {
+    if (key_cmp == compare_key_i32 || key_cmp == compare_key_u32) {
+        return key_size == sizeof(uint32_t);
+    }
+    if (key_cmp == compare_key_i64 || key_cmp == compare_key_u64) {
+        return key_size == sizeof(uint64_t);
+    }
+    return false;
+}
+
+/**
+ * @brief Sort the list by keys computed once per element.
+ */
+bool list_sort_by_key(List *list, KeyFunc key_fn, size_t key_size, CompareFunc key_cmp) {
+    if (!list || !key_fn || key_size == 0 || !key_cmp || !list_has_chain(list)) return false;
+    size_t n = list->size;
+    if (n < 2) return true;
+
+    Node **nodes = malloc(sizeof(Node *) * n);
+    char *keys = malloc(key_size * n);
+    if (!nodes || !keys) {
+        free(keys);
+        free(nodes);
+        return false;
+    }
+
+    // The only calls to key_fn, one per element
+    Node *cur = list->sentinel->next;
+    for (size_t i = 0; i < n; i++, cur = cur->next) {
+        nodes[i] = cur;
+        key_fn(cur->data, keys + i * key_size);
+    }
+
+    Node **order = malloc(sizeof(Node *) * n);
+    bool ok = order != NULL;
+    if (ok && radix_applies(key_size, key_cmp)) {
+        RadixItem *items = malloc(sizeof(RadixItem) * n);
+        RadixItem *tmp = malloc(sizeof(RadixItem) * n);
+        RadixItem *sorted = NULL;
+        if (items && tmp) {
+            for (size_t i = 0; i < n; i++) {
+                items[i] = (RadixItem){ radix_key(keys + i * key_size, key_cmp), i };
+            }
+            sorted = radix_sort(items, tmp, n, key_size);
+        }
+        ok = sorted != NULL;
+        for (size_t i = 0; ok && i < n; i++) {
+            order[i] = nodes[sorted[i].index];
+        }
+        free(tmp);
+        free(items);
+    } else if (ok) {
+        // Sort pointers to the keys; a key's offset gives its node back
+        void **refs = malloc(sizeof(void *) * n);
+        ok = refs != NULL;
+        if (ok) {
+            for (size_t i = 0; i < n; i++) {
+                refs[i] = keys + i * key_size;
+            }
+            lab_introsort(refs, n, compare_key_stable, &(PlainCompare){ key_cmp });
+            for (size_t i = 0; i < n; i++) {
+                order[i] = nodes[(size_t)((char *)refs[i] - keys) / key_size];
+            }
+        }
+        free(refs);
+    }
+
+    // Relink the nodes in key order; payloads stay with their nodes
+    if (ok) {
+        Node *prev = list->sentinel;
+        for (size_t i = 0; i < n; i++) {
+            prev->next = order[i];
+            order[i]->prev = prev;
+            prev = order[i];
+        }
+        prev->next = list->sentinel;
+        list->sentinel->prev = prev;
+    }
+
+    free(order);
+    free(keys);
+    free(nodes);
+    return ok;
+}
@@ -0,0 +1,313 @@
+#include "lab_internal.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* === Thread helpers === */
+
+/**
+ * @brief Resolve a caller supplied thread count.
+ */
+size_t lab_thread_count(size_t requested, size_t work) {
+    if (requested == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        requested = cpus > 0 ? (size_t)cpus : 1;
+    }
+    if (requested > work) {
+        requested = work;
+    }
+    return requested > 0 ? requested : 1;
+}
+
+/**
+ * @brief Run fn over nthreads argument blocks and wait for all of them.
+ */
+void lab_parallel_run(size_t nthreads, void *(*fn)(void *), void *args, size_t stride) {
+    if (nthreads == 0) return;
+
+    pthread_t *threads = malloc(sizeof(pthread_t) * nthreads);
+    bool *started = calloc(nthreads, sizeof(bool));
+    char *base = (char *)args;
+
+    for (size_t t = 0; t + 1 < nthreads; t++) {
+        if (threads && started &&
+            pthread_create(&threads[t], NULL, fn, base + t * stride) == 0) {
+            started[t] = true;
+        } else {
+            fn(base + t * stride);
+        }
+    }
+    fn(base + (nthreads - 1) * stride);
+
+    for (size_t t = 0; t + 1 < nthreads; t++) {
+        if (started && started[t]) {
+            pthread_join(threads[t], NULL);
+        }
+    }
+    free(started);
+    free(threads);
+}
+
+/**
+ * @brief Split the node chain of a list into nseg contiguous segments.
+ * Segment t runs from starts[t] up to (not including) starts[t + 1];
+ * starts[nseg] is the sentinel. Costs one walk of the chain, no comparisons.
+ * @param starts Array of nseg + 1 entries.
+ */
+static void chain_segments(const List *list, size_t nseg, Node **starts) {
+    Node *cur = list->sentinel->next;
+    size_t pos = 0;
+    for (size_t t = 0; t < nseg; t++) {
+        size_t begin = list->size * t / nseg;
+        for (; pos < begin; pos++) {
+            cur = cur->next;
+        }
+        starts[t] = cur;
+    }
+    starts[nseg] = list->sentinel;
+}
+
+/* === Parallel merge === */
+
+/**
+ * @brief Copy the data pointers of a list into a new array.
+ * @return The array (NULL for an empty list or on failure).
+ */
+static void **snapshot_data(const List *list) {
+    if (list->size == 0) return NULL;
+    void **items = malloc(sizeof(void *) * list->size);
+    if (!items) return NULL;
+
+    list_to_array(list, items, list->size);
+    return items;
+}
+
+/**
+ * @brief Co-rank search: how many of the first k merged outputs come from a.
+ * Ties go to a, which keeps the result identical to the serial merge().
+ */
+static size_t co_rank(size_t k, void **a, size_t m, void **b, size_t n, CompareFunc cmp) {
+    size_t lo = k > n ? k - n : 0;
+    size_t hi = k < m ? k : m;
+
+    while (lo < hi) {
+        size_t i = lo + (hi - lo + 1) / 2;
+        size_t j = k - i;
+        // a[i - 1] is among the first k outputs iff it does not follow b[j]
+        if (j >= n || cmp(a[i - 1], b[j]) <= 0) {
+            lo = i;
+        } else {
+            hi = i - 1;
+        }
+    }
+    return lo;
+}
+
+typedef struct {
+    void **a;
+    void **b;
+    size_t a_lo, a_hi;
+    size_t b_lo, b_hi;
+    CompareFunc cmp;
+    Node *nodes;
+} MergeTask;
+
+/**
+ * @brief Merge one co-ranked slice of the inputs into its share of the
+ * output block, linking the nodes as it goes.
+ */
+static void *merge_slice(void *arg) {
+    MergeTask *task = (MergeTask *)arg;
+    size_t i = task->a_lo;
+    size_t j = task->b_lo;
+    Node *node = task->nodes;
+
+    while (i < task->a_hi || j < task->b_hi) {
+        if (j >= task->b_hi || (i < task->a_hi && task->cmp(task->a[i], task->b[j]) <= 0)) {
+            node->data = task->a[i++];
+        } else {
+            node->data = task->b[j++];
+        }
+        node->prev = node - 1;
+        node->next = node + 1;
+        node++;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Merges two sorted lists into a new sorted list using several threads.
+ */
+List *list_merge_parallel(const List *a, const List *b, CompareFunc cmp, size_t nthreads) {
+    if (!a || !b || !cmp) return NULL;
+
+    size_t m = a->size;
+    size_t n = b->size;
+    size_t total = m + n;
+    nthreads = lab_thread_count(nthreads, total);
+    // The slices link pool nodes, so only linked results are built here
+    if (nthreads == 1 || lab_merge_type(a, b) != LIST_LINKED_SENTINEL) {
+        return merge(a, b, cmp);
+    }
+
+    List *out = list_create(LIST_LINKED_SENTINEL);
+    bool shared = out && lab_share_values(out, a) && lab_share_values(out, b);
+    Node *nodes = shared ? pool_alloc(&out->pool, total) : NULL;
+    void **sa = snapshot_data(a);
+    void **sb = snapshot_data(b);
+    MergeTask *tasks = calloc(nthreads, sizeof(MergeTask));
+    if (!nodes || (m && !sa) || (n && !sb) || !tasks) {
+        free(tasks);
+        free(sb);
+        free(sa);
+        list_destroy(out, NULL);
+        return NULL;
+    }
+
+    // Split the output into equal pieces; each boundary is co-ranked independently
+    size_t prev_i = 0;
+    size_t prev_k = 0;
+    for (size_t t = 0; t < nthreads; t++) {
+        size_t k_hi = total * (t + 1) / nthreads;
+        size_t i_hi = co_rank(k_hi, sa, m, sb, n, cmp);
+        tasks[t] = (MergeTask){
+            .a = sa, .b = sb,
+            .a_lo = prev_i, .a_hi = i_hi,
+            .b_lo = prev_k - prev_i, .b_hi = k_hi - i_hi,
+            .cmp = cmp,
+            .nodes = nodes + prev_k,
+        };
+        prev_i = i_hi;
+        prev_k = k_hi;
+    }
+
+    // Every slice links into the same block, so only the ends need fixing
+    lab_parallel_run(nthreads, merge_slice, tasks, sizeof(MergeTask));
+    nodes[0].prev = out->sentinel;
+    nodes[total - 1].next = out->sentinel;
+    out->sentinel->next = &nodes[0];
+    out->sentinel->prev = &nodes[total - 1];
+    out->size = total;
+
+    free(tasks);
+    free(sb);
+    free(sa);
+    return out;
+}
+
+/* === Parallel destroy === */
+
+typedef struct {
+    Node *first;
+    Node *stop;
+    FreeFunc free_func;
+} DestroyTask;
+
+/**
+ * @brief Free the payloads of one chain segment.
+ */
+static void *destroy_segment(void *arg) {
+    DestroyTask *task = (DestroyTask *)arg;
+    for (Node *current = task->first; current != task->stop; current = current->next) {
+        if (current->data != NULL) {
+            task->free_func(current->data);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Destroy the list, freeing payloads and nodes on several threads.
+ */
+void list_destroy_parallel(List *list, FreeFunc free_func, size_t nthreads) {
+    if (list == NULL) {
+        return;
+    }
+
+    // Without payloads to free only whole slabs are handed back
+    nthreads = free_func && list_has_chain(list) && list->value_size == 0
+                   ? lab_thread_count(nthreads, list->size) : 1;
+    Node **starts = malloc(sizeof(Node *) * (nthreads + 1));
+    DestroyTask *tasks = malloc(sizeof(DestroyTask) * nthreads);
+    if (nthreads == 1 || !starts || !tasks) {
+        free(tasks);
+        free(starts);
+        list_destroy(list, free_func);
+        return;
+    }
+
+    // Boundaries are collected before any node is freed
+    chain_segments(list, nthreads, starts);
+    for (size_t t = 0; t < nthreads; t++) {
+        tasks[t] = (DestroyTask){ starts[t], starts[t + 1], free_func };
+    }
+    lab_parallel_run(nthreads, destroy_segment, tasks, sizeof(DestroyTask));
+
+    free(tasks);
+    free(starts);
+    list_destroy(list, NULL);
+}
+
+/* === Parallel is_sorted === */
+
+// How many pairs a worker checks between looks at the shared stop flag
+#define SORTED_POLL_INTERVAL 1024
+
+typedef struct {
+    Node *first;
+    Node *stop;
+    Node *sentinel;
+    CompareFunc cmp;
+    atomic_bool *violation;
+} SortedTask;
+
+/**
+ * @brief Check the pairs of one segment, including the pair that crosses
+ * into the next segment. Stops early once any worker has found a violation.
+ */
+static void *check_segment(void *arg) {
+    SortedTask *task = (SortedTask *)arg;
+    size_t until_poll = SORTED_POLL_INTERVAL;
+
+    for (Node *cur = task->first; cur != task->stop; cur = cur->next) {
+        if (cur->next == task->sentinel) break;
+        if (task->cmp(cur->data, cur->next->data) > 0) {
+            atomic_store_explicit(task->violation, true, memory_order_relaxed);
+            break;
+        }
+        if (--until_poll == 0) {
+            if (atomic_load_explicit(task->violation, memory_order_relaxed)) break;
+            until_poll = SORTED_POLL_INTERVAL;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Checks if the list is sorted according to cmp using several threads.
+ */
+bool list_is_sorted_parallel(const List *list, CompareFunc cmp, size_t nthreads) {
+    if (!list || list->size < 2) return true;
+
+    // Every segment needs at least one pair to check
+    nthreads = lab_thread_count(nthreads, list->size - 1);
+    Node **starts = malloc(sizeof(Node *) * (nthreads + 1));
+    SortedTask *tasks = malloc(sizeof(SortedTask) * nthreads);
+    if (nthreads == 1 || !starts || !tasks || !list_has_chain(list)) {
+        free(tasks);
+        free(starts);
+        return is_sorted(list, cmp);
+    }
+
+    atomic_bool violation = false;
+    chain_segments(list, nthreads, starts);
+    for (size_t t = 0; t < nthreads; t++) {
+        tasks[t] = (SortedTask){ starts[t], starts[t + 1], list->sentinel, cmp, &violation };
+    }
+    lab_parallel_run(nthreads, check_segment, tasks, sizeof(SortedTask));
+
+    free(tasks);
+    free(starts);
+    return !atomic_load(&violation);
+}
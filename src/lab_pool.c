@@ -0,0 +1,183 @@
+#include "lab_internal.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+// First slab of a list holds this many nodes, later ones double up to the max
+#define SLAB_MIN_NODES 16
+#define SLAB_MAX_NODES 65536
+
+/**
+ * @brief Drop one reference to a slab and free it if it was the last one.
+ */
+static void slab_unref(NodeSlab *slab) {
+    if (atomic_fetch_sub_explicit(&slab->refs, 1, memory_order_acq_rel) == 1) {
+        free(slab);
+    }
+}
+
+/**
+ * @brief Make room for at least extra more slab references.
+ */
+static bool pool_reserve(NodePool *pool, size_t extra) {
+    size_t need = pool->slab_count + extra;
+    if (need <= pool->slab_cap) {
+        return true;
+    }
+    size_t cap = pool->slab_cap ? pool->slab_cap * 2 : 4;
+    while (cap < need) {
+        cap *= 2;
+    }
+    NodeSlab **slabs = realloc(pool->slabs, sizeof(NodeSlab *) * cap);
+    if (slabs == NULL) {
+        return false;
+    }
+    pool->slabs = slabs;
+    pool->slab_cap = cap;
+    return true;
+}
+
+/**
+ * @brief Insert a freshly allocated slab into the sorted reference array.
+ */
+static void pool_insert_ref(NodePool *pool, NodeSlab *slab) {
+    size_t i = pool->slab_count;
+    while (i > 0 && pool->slabs[i - 1] > slab) {
+        pool->slabs[i] = pool->slabs[i - 1];
+        i--;
+    }
+    pool->slabs[i] = slab;
+    pool->slab_count++;
+}
+
+/**
+ * @brief Allocate n contiguous unlinked nodes.
+ */
+Node *pool_alloc(NodePool *pool, size_t n) {
+    if (n == 0) {
+        return NULL;
+    }
+    if (pool->bump_left >= n) {
+        Node *nodes = pool->bump;
+        pool->bump = pool_node(pool, nodes, n);
+        pool->bump_left -= n;
+        return nodes;
+    }
+
+    if (pool->grow < SLAB_MIN_NODES) {
+        pool->grow = SLAB_MIN_NODES;
+    }
+    size_t count = n > pool->grow ? n : pool->grow;
+    if (count > (SIZE_MAX - sizeof(NodeSlab)) / pool->stride || !pool_reserve(pool, 1)) {
+        return NULL;
+    }
+    NodeSlab *slab = malloc(sizeof(NodeSlab) + pool->stride * count);
+    if (slab == NULL) {
+        return NULL;
+    }
+    atomic_init(&slab->refs, 1);
+    slab->count = count;
+    pool_insert_ref(pool, slab);
+
+    if (pool->grow < SLAB_MAX_NODES) {
+        pool->grow *= 2;
+    }
+    // Keep whichever leftover is bigger for the next small allocations
+    if (count - n > pool->bump_left) {
+        pool->bump = pool_node(pool, slab->nodes, n);
+        pool->bump_left = count - n;
+    }
+    return slab->nodes;
+}
+
+/**
+ * @brief Allocate a single node, reusing a freed one if possible.
+ */
+Node *pool_alloc_one(NodePool *pool) {
+    Node *node = pool->free_nodes;
+    if (node != NULL) {
+        pool->free_nodes = node->next;
+        return node;
+    }
+    return pool_alloc(pool, 1);
+}
+
+/**
+ * @brief Give an unlinked node back for reuse by the same list.
+ */
+void pool_free_one(NodePool *pool, Node *node) {
+    node->data = NULL;
+    node->prev = NULL;
+    node->next = pool->free_nodes;
+    pool->free_nodes = node;
+}
+
+/**
+ * @brief Merge the sorted references of src into dst, skipping ones dst has.
+ * @param acquire true to take a new reference on every slab added to dst,
+ * false when src's references are handed over (duplicates are then dropped).
+ */
+static bool pool_merge_refs(NodePool *dst, NodeSlab **refs, size_t count, bool acquire) {
+    if (count == 0) {
+        return true;
+    }
+    size_t total = dst->slab_count + count;
+    NodeSlab **merged = malloc(sizeof(NodeSlab *) * total);
+    if (merged == NULL) {
+        return false;
+    }
+
+    size_t i = 0, j = 0, k = 0;
+    while (i < dst->slab_count || j < count) {
+        if (j >= count || (i < dst->slab_count && dst->slabs[i] < refs[j])) {
+            merged[k++] = dst->slabs[i++];
+        } else if (i >= dst->slab_count || refs[j] < dst->slabs[i]) {
+            if (acquire) {
+                atomic_fetch_add_explicit(&refs[j]->refs, 1, memory_order_relaxed);
+            }
+            merged[k++] = refs[j++];
+        } else {
+            // Already referenced by dst
+            if (!acquire) {
+                slab_unref(refs[j]);
+            }
+            merged[k++] = dst->slabs[i++];
+            j++;
+        }
+    }
+
+    free(dst->slabs);
+    dst->slabs = merged;
+    dst->slab_count = k;
+    dst->slab_cap = total;
+    return true;
+}
+
+/**
+ * @brief Make dst hold a reference to every slab src holds.
+ */
+bool pool_share(NodePool *dst, const NodePool *src) {
+    return pool_merge_refs(dst, src->slabs, src->slab_count, true);
+}
+
+/**
+ * @brief Move every slab reference from src into dst.
+ */
+bool pool_take(NodePool *dst, NodePool *src) {
+    if (!pool_merge_refs(dst, src->slabs, src->slab_count, false)) {
+        return false;
+    }
+    free(src->slabs);
+    *src = (NodePool){ .grow = src->grow, .stride = src->stride };
+    return true;
+}
+
+/**
+ * @brief Drop every slab reference, freeing slabs no other list uses.
+ */
+void pool_release(NodePool *pool) {
+    for (size_t i = 0; i < pool->slab_count; i++) {
+        slab_unref(pool->slabs[i]);
+    }
+    free(pool->slabs);
+    *pool = (NodePool){ 0 };
+}
@@ -0,0 +1,235 @@
+#include "lab_internal.h"
+#include "lab_sort.h"
+#include <math.h>
+#include <stdlib.h>
+
+/* === Bounded heap for top-k === */
+
+/*
+ * Max-heap of elements ordered by cmp and then by list position, so the root
+ * is the worst of the best k seen so far and is the one to evict when a
+ * better element comes along. Equal elements rank by position, which keeps
+ * the earliest ones and leaves them in list order.
+ */
+typedef struct {
+    void *data;
+    size_t pos;     // index in the list, breaks ties
+} TopEntry;
+
+typedef struct {
+    TopEntry *entries;
+    size_t count;
+    size_t cap;
+    CompareFunc cmp;
+} TopHeap;
+
+/**
+ * @brief Whether entry a ranks below entry b.
+ */
+static inline bool top_worse(const TopHeap *h, const TopEntry *a, const TopEntry *b) {
+    int r = h->cmp(a->data, b->data);
+    return r > 0 || (r == 0 && a->pos > b->pos);
+}
+
+static void top_sift_up(TopHeap *h, size_t i) {
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!top_worse(h, &h->entries[i], &h->entries[parent])) return;
+        TopEntry tmp = h->entries[parent];
+        h->entries[parent] = h->entries[i];
+        h->entries[i] = tmp;
+        i = parent;
+    }
+}
+
+static void top_sift_down(TopHeap *h, size_t i) {
+    for (;;) {
+        size_t worst = i;
+        for (size_t c = 2 * i + 1; c <= 2 * i + 2 && c < h->count; c++) {
+            if (top_worse(h, &h->entries[c], &h->entries[worst])) {
+                worst = c;
+            }
+        }
+        if (worst == i) return;
+        TopEntry tmp = h->entries[worst];
+        h->entries[worst] = h->entries[i];
+        h->entries[i] = tmp;
+        i = worst;
+    }
+}
+
+/**
+ * @brief Collect the k best elements of the list in one pass, in sorted order.
+ * Earlier elements win ties against later ones and come first.
+ * @return Array of min(k, size) entries (caller frees), or NULL on failure.
+ */
+static TopEntry *collect_top(const List *list, size_t k, CompareFunc cmp, size_t *count) {
+    TopHeap h = { malloc(sizeof(TopEntry) * (k ? k : 1)), 0, k, cmp };
+    if (h.entries == NULL) return NULL;
+
+    ListIter it = list_iter(list);
+    void *data;
+    for (size_t pos = 0; list_next(&it, &data); pos++) {
+        if (h.count < h.cap) {
+            h.entries[h.count++] = (TopEntry){ data, pos };
+            top_sift_up(&h, h.count - 1);
+        } else if (h.cap > 0 && cmp(data, h.entries[0].data) < 0) {
+            // A later equal element loses the tie, so only strictly better ones get in
+            h.entries[0] = (TopEntry){ data, pos };
+            top_sift_down(&h, 0);
+        }
+    }
+
+    // Popping the worst into the freed slot at the back leaves them sorted
+    *count = h.count;
+    while (h.count > 1) {
+        TopEntry worst = h.entries[0];
+        h.entries[0] = h.entries[--h.count];
+        h.entries[h.count] = worst;
+        top_sift_down(&h, 0);
+    }
+    return h.entries;
+}
+
+/**
+ * @brief Copy the k best elements of the list, in sorted order, into out.
+ */
+size_t list_top_k(const List *list, size_t k, CompareFunc cmp, void **out) {
+    if (!list || !cmp || !out) return 0;
+
+    size_t count;
+    TopEntry *best = collect_top(list, k, cmp, &count);
+    if (best == NULL) return 0;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = best[i].data;
+    }
+    free(best);
+    return count;
+}
+
+// Rank of a winner by its position, to find the nodes in one walk
+typedef struct {
+    size_t pos;
+    size_t rank;
+} TopPlace;
+
+LIST_DEFINE_SORT(sort_places, TopPlace, (a).pos < (b).pos)
+
+/**
+ * @brief Move the k best elements, sorted, to the front of the list.
+ */
+bool list_partial_sort(List *list, size_t k, CompareFunc cmp) {
+    if (!list || !cmp || !list_has_chain(list)) return false;
+
+    size_t count;
+    TopEntry *best = collect_top(list, k, cmp, &count);
+    if (best == NULL) return false;
+    TopPlace *places = malloc(sizeof(TopPlace) * (count ? count : 1));
+    Node **nodes = malloc(sizeof(Node *) * (count ? count : 1));
+    if (!places || !nodes) {
+        free(places);
+        free(nodes);
+        free(best);
+        return false;
+    }
+
+    // The winners' nodes, ranked, from one walk in list order
+    for (size_t i = 0; i < count; i++) {
+        places[i] = (TopPlace){ best[i].pos, i };
+    }
+    sort_places(places, count);
+    Node *cur = list->sentinel->next;
+    size_t pos = 0;
+    for (size_t i = 0; i < count; i++) {
+        for (; pos < places[i].pos; pos++) {
+            cur = cur->next;
+        }
+        nodes[places[i].rank] = cur;
+    }
+    free(places);
+    free(best);
+
+    // Relink the winners at the front; the rest keep their relative order
+    Node *prev = list->sentinel;
+    for (size_t i = 0; i < count; i++) {
+        Node *node = nodes[i];
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+
+        node->prev = prev;
+        node->next = prev->next;
+        prev->next->prev = node;
+        prev->next = node;
+        prev = node;
+    }
+    free(nodes);
+    return true;
+}
+
+/* === Selection === */
+
+/**
+ * @brief Return the element that would sit at index k after sorting.
+ */
+void *list_select(const List *list, size_t k, CompareFunc cmp) {
+    if (!list || !cmp || k >= list->size) return NULL;
+
+    void **items = malloc(sizeof(void *) * list->size);
+    if (!items) return NULL;
+    list_to_array(list, items, list->size);
+
+    lab_introselect(items, list->size, k, lab_plain_compare, &(PlainCompare){ cmp });
+    void *result = items[k];
+    free(items);
+    return result;
+}
+
+/**
+ * @brief Look up several quantiles with a single selection pass.
+ */
+bool list_quantiles(const List *list, const double *qs, size_t nq, CompareFunc cmp, void **out) {
+    if (!list || !qs || !cmp || !out || list->size == 0) return false;
+    if (nq == 0) return true;
+    for (size_t i = 0; i < nq; i++) {
+        // NaN has no rank, and converting it to size_t is undefined
+        if (isnan(qs[i])) return false;
+    }
+
+    size_t n = list->size;
+    void **items = malloc(sizeof(void *) * n);
+    size_t *ranks = malloc(sizeof(size_t) * nq);
+    size_t *order = malloc(sizeof(size_t) * nq);
+    if (!items || !ranks || !order) {
+        free(order);
+        free(ranks);
+        free(items);
+        return false;
+    }
+    list_to_array(list, items, n);
+
+    for (size_t i = 0; i < nq; i++) {
+        double q = qs[i] < 0.0 ? 0.0 : qs[i] > 1.0 ? 1.0 : qs[i];
+        ranks[i] = (size_t)(q * (double)(n - 1));
+    }
+
+    // Selection wants the ranks ascending; there are few, insertion sort them
+    for (size_t i = 0; i < nq; i++) {
+        size_t r = ranks[i];
+        size_t j = i;
+        while (j > 0 && order[j - 1] > r) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = r;
+    }
+
+    lab_multiselect(items, n, order, nq, lab_plain_compare, &(PlainCompare){ cmp });
+    for (size_t i = 0; i < nq; i++) {
+        out[i] = items[ranks[i]];
+    }
+
+    free(order);
+    free(ranks);
+    free(items);
+    return true;
+}
@@ -0,0 +1,504 @@
+#include "lab_internal.h"
+#include "lab_sort.h"
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LAB_X86 1
+#endif
+
+/*
+ * Descending int sort built from sorting networks.
+ *
+ * The keys are processed in blocks of one "tile" (64 ints for AVX2, 16 for
+ * SSE4.1). A tile is loaded into registers, every register lane column is
+ * sorted with a fixed comparator network, the tile is transposed so each
+ * register holds a sorted run, and the runs are combined with in-register
+ * bitonic merges. Sorted tiles are then merged pairwise with a vectorized
+ * bitonic merge kernel. The input is padded with INT_MIN up to a whole
+ * number of tiles; in descending order the padding sorts to the end and is
+ * dropped again.
+ */
+
+/* === Runtime dispatch === */
+
+static atomic_int simd_cap = LIST_SIMD_AVX2;
+
+/**
+ * @brief Best SIMD level supported by the CPU this runs on.
+ */
+ListSimdLevel list_simd_level(void) {
+#ifdef LAB_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return LIST_SIMD_AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return LIST_SIMD_SSE4;
+#endif
+    return LIST_SIMD_SCALAR;
+}
+
+/**
+ * @brief Cap the SIMD level used by the int kernels.
+ */
+ListSimdLevel list_simd_limit(ListSimdLevel max) {
+    return (ListSimdLevel)atomic_exchange(&simd_cap, (int)max);
+}
+
+/**
+ * @brief Level the kernels should use: the CPU's best, capped by list_simd_limit().
+ */
+static ListSimdLevel simd_active(void) {
+    ListSimdLevel level = list_simd_level();
+    ListSimdLevel cap = (ListSimdLevel)atomic_load(&simd_cap);
+    return level < cap ? level : cap;
+}
+
+/* === Scalar fallback === */
+
+LIST_DEFINE_SORT(pdq_ints_desc, int, a > b)
+
+#ifdef LAB_X86
+
+/* === AVX2 kernels: 8 lanes, 64-int tiles === */
+
+#define AVX2_TILE 64
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+// Descending compare-exchange: the larger value ends up in a
+#define AVX2_CX(a, b) do { __m256i t_ = (a); (a) = _mm256_max_epi32(t_, (b)); (b) = _mm256_min_epi32(t_, (b)); } while (0)
+
+static inline AVX2_TARGET __m256i avx2_reverse(__m256i v) {
+    return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+/**
+ * @brief Sort a bitonic 8-lane register in descending order.
+ */
+static inline AVX2_TARGET __m256i avx2_bitonic_clean(__m256i v) {
+    __m256i p = _mm256_permute2x128_si256(v, v, 0x01);
+    v = _mm256_blend_epi32(_mm256_max_epi32(v, p), _mm256_min_epi32(v, p), 0xF0);
+    p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    v = _mm256_blend_epi32(_mm256_max_epi32(v, p), _mm256_min_epi32(v, p), 0xCC);
+    p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm256_blend_epi32(_mm256_max_epi32(v, p), _mm256_min_epi32(v, p), 0xAA);
+    return v;
+}
+
+/**
+ * @brief Sort a bitonic sequence spread over n registers (n a power of two).
+ */
+static inline AVX2_TARGET void avx2_bitonic_merge(__m256i *r, size_t n) {
+    for (size_t d = n / 2; d > 0; d /= 2) {
+        for (size_t i = 0; i < n; i++) {
+            if ((i & d) == 0) AVX2_CX(r[i], r[i + d]);
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        r[i] = avx2_bitonic_clean(r[i]);
+    }
+}
+
+/**
+ * @brief Merge the two sorted runs r[0, n/2) and r[n/2, n) into one.
+ */
+static inline AVX2_TARGET void avx2_merge_runs(__m256i *r, size_t n) {
+    size_t h = n / 2;
+    for (size_t i = 0; i < h / 2; i++) {
+        __m256i t = r[h + i];
+        r[h + i] = avx2_reverse(r[n - 1 - i]);
+        r[n - 1 - i] = avx2_reverse(t);
+    }
+    if (h == 1) r[1] = avx2_reverse(r[1]);
+    avx2_bitonic_merge(r, n);
+}
+
+/**
+ * @brief Transpose an 8x8 matrix of ints held in 8 registers.
+ */
+static inline AVX2_TARGET void avx2_transpose(__m256i *r) {
+    __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+    __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+    __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+    __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+    __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+    __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+    __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+    __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+    r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+/**
+ * @brief Sort one 64-int tile in registers.
+ */
+static AVX2_TARGET void avx2_sort_tile(int *v) {
+    __m256i r[8];
+    for (size_t i = 0; i < 8; i++) {
+        r[i] = _mm256_loadu_si256((const __m256i *)(v + 8 * i));
+    }
+
+    // 19-comparator network sorts every lane column
+    AVX2_CX(r[0], r[2]); AVX2_CX(r[1], r[3]); AVX2_CX(r[4], r[6]); AVX2_CX(r[5], r[7]);
+    AVX2_CX(r[0], r[4]); AVX2_CX(r[1], r[5]); AVX2_CX(r[2], r[6]); AVX2_CX(r[3], r[7]);
+    AVX2_CX(r[0], r[1]); AVX2_CX(r[2], r[3]); AVX2_CX(r[4], r[5]); AVX2_CX(r[6], r[7]);
+    AVX2_CX(r[2], r[4]); AVX2_CX(r[3], r[5]);
+    AVX2_CX(r[1], r[4]); AVX2_CX(r[3], r[6]);
+    AVX2_CX(r[1], r[2]); AVX2_CX(r[3], r[4]); AVX2_CX(r[5], r[6]);
+
+    // Columns become rows: eight sorted runs of 8, then 4 of 16, 2 of 32, 1 of 64
+    avx2_transpose(r);
+    for (size_t run = 2; run <= 8; run *= 2) {
+        for (size_t i = 0; i < 8; i += run) {
+            avx2_merge_runs(r + i, run);
+        }
+    }
+
+    for (size_t i = 0; i < 8; i++) {
+        _mm256_storeu_si256((__m256i *)(v + 8 * i), r[i]);
+    }
+}
+
+/**
+ * @brief Merge two sorted runs whose lengths are multiples of 8 into out.
+ */
+static AVX2_TARGET void avx2_merge(const int *a, size_t na, const int *b, size_t nb, int *out) {
+    const int *a_end = a + na;
+    const int *b_end = b + nb;
+    __m256i r[2];
+    r[0] = _mm256_loadu_si256((const __m256i *)a);
+    r[1] = _mm256_loadu_si256((const __m256i *)b);
+    a += 8;
+    b += 8;
+
+    for (;;) {
+        avx2_merge_runs(r, 2);
+        _mm256_storeu_si256((__m256i *)out, r[0]);
+        out += 8;
+
+        // Refill from the run whose next key is larger
+        const int **src;
+        if (a < a_end && (b >= b_end || *a >= *b)) {
+            src = &a;
+        } else if (b < b_end) {
+            src = &b;
+        } else {
+            break;
+        }
+        r[0] = r[1];
+        r[1] = _mm256_loadu_si256((const __m256i *)*src);
+        *src += 8;
+    }
+    _mm256_storeu_si256((__m256i *)out, r[1]);
+}
+
+/* === SSE4.1 kernels: 4 lanes, 16-int tiles === */
+
+#define SSE4_TILE 16
+
+#define SSE4_TARGET __attribute__((target("sse4.1")))
+
+#define SSE4_CX(a, b) do { __m128i t_ = (a); (a) = _mm_max_epi32(t_, (b)); (b) = _mm_min_epi32(t_, (b)); } while (0)
+
+static inline SSE4_TARGET __m128i sse4_reverse(__m128i v) {
+    return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+static inline SSE4_TARGET __m128i sse4_bitonic_clean(__m128i v) {
+    __m128i p = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    v = _mm_blend_epi16(_mm_max_epi32(v, p), _mm_min_epi32(v, p), 0xF0);
+    p = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm_blend_epi16(_mm_max_epi32(v, p), _mm_min_epi32(v, p), 0xCC);
+    return v;
+}
+
+static inline SSE4_TARGET void sse4_bitonic_merge(__m128i *r, size_t n) {
+    for (size_t d = n / 2; d > 0; d /= 2) {
+        for (size_t i = 0; i < n; i++) {
+            if ((i & d) == 0) SSE4_CX(r[i], r[i + d]);
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        r[i] = sse4_bitonic_clean(r[i]);
+    }
+}
+
+static inline SSE4_TARGET void sse4_merge_runs(__m128i *r, size_t n) {
+    size_t h = n / 2;
+    for (size_t i = 0; i < h / 2; i++) {
+        __m128i t = r[h + i];
+        r[h + i] = sse4_reverse(r[n - 1 - i]);
+        r[n - 1 - i] = sse4_reverse(t);
+    }
+    if (h == 1) r[1] = sse4_reverse(r[1]);
+    sse4_bitonic_merge(r, n);
+}
+
+static SSE4_TARGET void sse4_sort_tile(int *v) {
+    __m128i r[4];
+    for (size_t i = 0; i < 4; i++) {
+        r[i] = _mm_loadu_si128((const __m128i *)(v + 4 * i));
+    }
+
+    // 5-comparator network sorts every lane column
+    SSE4_CX(r[0], r[1]); SSE4_CX(r[2], r[3]);
+    SSE4_CX(r[0], r[2]); SSE4_CX(r[1], r[3]);
+    SSE4_CX(r[1], r[2]);
+
+    // Transpose the 4x4 tile
+    __m128i t0 = _mm_unpacklo_epi32(r[0], r[1]);
+    __m128i t1 = _mm_unpackhi_epi32(r[0], r[1]);
+    __m128i t2 = _mm_unpacklo_epi32(r[2], r[3]);
+    __m128i t3 = _mm_unpackhi_epi32(r[2], r[3]);
+    r[0] = _mm_unpacklo_epi64(t0, t2);
+    r[1] = _mm_unpackhi_epi64(t0, t2);
+    r[2] = _mm_unpacklo_epi64(t1, t3);
+    r[3] = _mm_unpackhi_epi64(t1, t3);
+
+    for (size_t run = 2; run <= 4; run *= 2) {
+        for (size_t i = 0; i < 4; i += run) {
+            sse4_merge_runs(r + i, run);
+        }
+    }
+
+    for (size_t i = 0; i < 4; i++) {
+        _mm_storeu_si128((__m128i *)(v + 4 * i), r[i]);
+    }
+}
+
+static SSE4_TARGET void sse4_merge(const int *a, size_t na, const int *b, size_t nb, int *out) {
+    const int *a_end = a + na;
+    const int *b_end = b + nb;
+    __m128i r[2];
+    r[0] = _mm_loadu_si128((const __m128i *)a);
+    r[1] = _mm_loadu_si128((const __m128i *)b);
+    a += 4;
+    b += 4;
+
+    for (;;) {
+        sse4_merge_runs(r, 2);
+        _mm_storeu_si128((__m128i *)out, r[0]);
+        out += 4;
+
+        const int **src;
+        if (a < a_end && (b >= b_end || *a >= *b)) {
+            src = &a;
+        } else if (b < b_end) {
+            src = &b;
+        } else {
+            break;
+        }
+        r[0] = r[1];
+        r[1] = _mm_loadu_si128((const __m128i *)*src);
+        *src += 4;
+    }
+    _mm_storeu_si128((__m128i *)out, r[1]);
+}
+
+/* === Tiled merge sort driver === */
+
+typedef void (*TileSortFunc)(int *);
+typedef void (*RunMergeFunc)(const int *, size_t, const int *, size_t, int *);
+
+/**
+ * @brief Sort padded keys: tiles in registers, then bottom-up vector merges.
+ * @param buf Keys, padded to a multiple of tile; receives the result.
+ * @param tmp Scratch array of the same size.
+ */
+static void tiled_sort(int *buf, int *tmp, size_t padded, size_t tile,
+                       TileSortFunc sort_tile, RunMergeFunc merge_runs) {
+    for (size_t i = 0; i < padded; i += tile) {
+        sort_tile(buf + i);
+    }
+
+    int *src = buf;
+    int *dst = tmp;
+    for (size_t run = tile; run < padded; run *= 2) {
+        for (size_t i = 0; i < padded; i += 2 * run) {
+            size_t na = padded - i < run ? padded - i : run;
+            size_t nb = padded - i - na < run ? padded - i - na : run;
+            if (nb == 0) {
+                memcpy(dst + i, src + i, sizeof(int) * na);
+            } else {
+                merge_runs(src + i, na, src + i + na, nb, dst + i);
+            }
+        }
+        int *swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != buf) {
+        memcpy(buf, src, sizeof(int) * padded);
+    }
+}
+
+#endif // LAB_X86
+
+/**
+ * @brief Sort ints in descending order with the best available kernel.
+ */
+bool list_sort_ints_desc(int *keys, size_t n) {
+    if (n < 2) return true;
+
+#ifdef LAB_X86
+    ListSimdLevel level = simd_active();
+    if (level != LIST_SIMD_SCALAR) {
+        size_t tile = level == LIST_SIMD_AVX2 ? AVX2_TILE : SSE4_TILE;
+        size_t padded = (n + tile - 1) / tile * tile;
+        int *buf = malloc(sizeof(int) * padded * 2);
+        if (!buf) return false;
+
+        memcpy(buf, keys, sizeof(int) * n);
+        for (size_t i = n; i < padded; i++) {
+            buf[i] = INT_MIN;
+        }
+        if (level == LIST_SIMD_AVX2) {
+            tiled_sort(buf, buf + padded, padded, tile, avx2_sort_tile, avx2_merge);
+        } else {
+            tiled_sort(buf, buf + padded, padded, tile, sse4_sort_tile, sse4_merge);
+        }
+        memcpy(keys, buf, sizeof(int) * n);
+        free(buf);
+        return true;
+    }
+#endif
+    pdq_ints_desc(keys, n);
+    return true;
+}
+
+/**
+ * @brief Sort int elements between start and end (inclusive) in compare_int order.
+ */
+bool list_sort_int(List *list, size_t start, size_t end) {
+    if (!list || !(list_has_chain(list) || list->type == LIST_COMPACT || list->type == LIST_XOR) ||
+        end >= list->size) {
+        return false;
+    }
+    if (start >= end) return true;
+
+    // Wider inline values must move whole, compact and XOR lists have no node chain
+    if (list->value_size > sizeof(int) || !list_has_chain(list)) {
+        sort(list, start, end, compare_int);
+        return true;
+    }
+
+    size_t count = end - start + 1;
+    int *keys = malloc(sizeof(int) * count);
+    if (!keys) return false;
+
+    Node *first = list->sentinel->next;
+    for (size_t i = 0; i < start; i++) {
+        first = first->next;
+    }
+    Node *cur = first;
+    for (size_t i = 0; i < count; i++, cur = cur->next) {
+        keys[i] = *(const int *)cur->data;
+    }
+
+    bool ok = list_sort_ints_desc(keys, count);
+    if (ok) {
+        cur = first;
+        for (size_t i = 0; i < count; i++, cur = cur->next) {
+            *(int *)cur->data = keys[i];
+        }
+    }
+    free(keys);
+    return ok;
+}
+
+/* === Sortedness check === */
+
+// Keys gathered from the chain per batch; one extra slot carries the last key over
+#define SORTED_BATCH 256
+
+#ifdef LAB_X86
+/**
+ * @brief True if keys[0, n) has a pair keys[i] < keys[i + 1].
+ */
+static AVX2_TARGET bool avx2_has_ascent(const int *keys, size_t n) {
+    size_t i = 0;
+    __m256i bad = _mm256_setzero_si256();
+    for (; i + 9 <= n; i += 8) {
+        __m256i cur = _mm256_loadu_si256((const __m256i *)(keys + i));
+        __m256i next = _mm256_loadu_si256((const __m256i *)(keys + i + 1));
+        bad = _mm256_or_si256(bad, _mm256_cmpgt_epi32(next, cur));
+    }
+    if (!_mm256_testz_si256(bad, bad)) return true;
+    for (; i + 1 < n; i++) {
+        if (keys[i] < keys[i + 1]) return true;
+    }
+    return false;
+}
+
+static SSE4_TARGET bool sse4_has_ascent(const int *keys, size_t n) {
+    size_t i = 0;
+    __m128i bad = _mm_setzero_si128();
+    for (; i + 5 <= n; i += 4) {
+        __m128i cur = _mm_loadu_si128((const __m128i *)(keys + i));
+        __m128i next = _mm_loadu_si128((const __m128i *)(keys + i + 1));
+        bad = _mm_or_si128(bad, _mm_cmpgt_epi32(next, cur));
+    }
+    if (!_mm_testz_si128(bad, bad)) return true;
+    for (; i + 1 < n; i++) {
+        if (keys[i] < keys[i + 1]) return true;
+    }
+    return false;
+}
+#endif
+
+static bool scalar_has_ascent(const int *keys, size_t n) {
+    for (size_t i = 0; i + 1 < n; i++) {
+        if (keys[i] < keys[i + 1]) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Check that int elements are in compare_int order.
+ */
+bool list_is_sorted_int(const List *list) {
+    if (!list || list->size < 2) return true;
+    if (!list_has_chain(list)) return is_sorted(list, compare_int);
+
+    bool (*has_ascent)(const int *, size_t) = scalar_has_ascent;
+#ifdef LAB_X86
+    ListSimdLevel level = simd_active();
+    if (level == LIST_SIMD_AVX2) {
+        has_ascent = avx2_has_ascent;
+    } else if (level == LIST_SIMD_SSE4) {
+        has_ascent = sse4_has_ascent;
+    }
+#endif
+
+    int keys[SORTED_BATCH + 1];
+    Node *cur = list->sentinel->next;
+    keys[0] = *(const int *)cur->data;
+    cur = cur->next;
+
+    // keys[0] is the last key of the previous batch, so boundary pairs are checked too
+    while (cur != list->sentinel) {
+        size_t n = 1;
+        for (; n <= SORTED_BATCH && cur != list->sentinel; n++, cur = cur->next) {
+            keys[n] = *(const int *)cur->data;
+        }
+        if (has_ascent(keys, n)) return false;
+        keys[0] = keys[n - 1];
+    }
+    return true;
+}
@@ -0,0 +1,388 @@
+#include "lab_internal.h"
+#include "lab_sort.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* === Compare function adapter === */
+
+/**
+ * @brief Call the plain compare function wrapped in ctx.
+ */
+int lab_plain_compare(const void *a, const void *b, void *ctx) {
+    return ((const PlainCompare *)ctx)->cmp(a, b);
+}
+
+/* === Introsort over arrays of element pointers === */
+
+// Partitions at or below this size are left for insertion sort
+#define INTRO_SMALL 16
+
+static inline void swap_items(void **a, void **b) {
+    void *tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+/**
+ * @brief Insertion sort, used for the small partitions introsort leaves behind.
+ */
+static void insertion_sort(void **items, size_t n, CompareFuncCtx cmp, void *ctx) {
+    for (size_t i = 1; i < n; i++) {
+        void *cur = items[i];
+        size_t j = i;
+        while (j > 0 && cmp(items[j - 1], cur, ctx) > 0) {
+            items[j] = items[j - 1];
+            j--;
+        }
+        items[j] = cur;
+    }
+}
+
+static void sift_down(void **items, size_t root, size_t n, CompareFuncCtx cmp, void *ctx) {
+    for (;;) {
+        size_t child = 2 * root + 1;
+        if (child >= n) return;
+        if (child + 1 < n && cmp(items[child], items[child + 1], ctx) < 0) {
+            child++;
+        }
+        if (cmp(items[root], items[child], ctx) >= 0) return;
+        swap_items(&items[root], &items[child]);
+        root = child;
+    }
+}
+
+/**
+ * @brief Heapsort fallback that bounds introsort's worst case at O(n log n).
+ */
+static void heap_sort(void **items, size_t n, CompareFuncCtx cmp, void *ctx) {
+    for (size_t i = n / 2; i-- > 0;) {
+        sift_down(items, i, n, cmp, ctx);
+    }
+    for (size_t end = n; end-- > 1;) {
+        swap_items(&items[0], &items[end]);
+        sift_down(items, 0, end, cmp, ctx);
+    }
+}
+
+/**
+ * @brief Move the median of the first, middle and last item to the front.
+ */
+static void median_to_front(void **items, size_t n, CompareFuncCtx cmp, void *ctx) {
+    void **a = &items[1];
+    void **b = &items[n / 2];
+    void **c = &items[n - 1];
+    if (cmp(*a, *b, ctx) > 0) swap_items(a, b);
+    if (cmp(*b, *c, ctx) > 0) swap_items(b, c);
+    if (cmp(*a, *b, ctx) > 0) swap_items(a, b);
+    swap_items(&items[0], b);
+}
+
+/**
+ * @brief Hoare partition around items[0].
+ * @return Index j such that [0, j] <= pivot <= [j + 1, n), with j < n - 1.
+ */
+static size_t partition(void **items, size_t n, CompareFuncCtx cmp, void *ctx) {
+    void *pivot = items[0];
+    size_t i = 0;
+    size_t j = n;
+    for (;;) {
+        do { j--; } while (cmp(pivot, items[j], ctx) < 0);
+        while (cmp(items[i], pivot, ctx) < 0) i++;
+        if (i >= j) return j;
+        swap_items(&items[i], &items[j]);
+        i++;
+    }
+}
+
+/**
+ * @brief Depth budget before falling back to heapsort, 2 * log2(n).
+ */
+static size_t intro_depth(size_t n) {
+    size_t depth = 0;
+    for (size_t m = n; m > 1; m >>= 1) {
+        depth += 2;
+    }
+    return depth;
+}
+
+static void introsort_loop(void **items, size_t n, size_t depth, CompareFuncCtx cmp, void *ctx) {
+    while (n > INTRO_SMALL) {
+        if (depth == 0) {
+            heap_sort(items, n, cmp, ctx);
+            return;
+        }
+        depth--;
+        median_to_front(items, n, cmp, ctx);
+        size_t split = partition(items, n, cmp, ctx) + 1;
+
+        // Recurse into the smaller side, loop on the larger one
+        if (split < n - split) {
+            introsort_loop(items, split, depth, cmp, ctx);
+            items += split;
+            n -= split;
+        } else {
+            introsort_loop(items + split, n - split, depth, cmp, ctx);
+            n = split;
+        }
+    }
+}
+
+/**
+ * @brief Sort an array of element pointers with introsort.
+ */
+void lab_introsort(void **items, size_t n, CompareFuncCtx cmp, void *ctx) {
+    if (n < 2) return;
+    introsort_loop(items, n, intro_depth(n), cmp, ctx);
+    insertion_sort(items, n, cmp, ctx);
+}
+
+/* === Introselect === */
+
+/**
+ * @brief Rearrange items so items[k] is the element a full sort would put there.
+ */
+void lab_introselect(void **items, size_t n, size_t k, CompareFuncCtx cmp, void *ctx) {
+    if (k >= n) return;
+    size_t depth = intro_depth(n);
+
+    // Only the side holding k is kept, so the expected cost is linear
+    while (n > INTRO_SMALL) {
+        if (depth == 0) {
+            heap_sort(items, n, cmp, ctx);
+            return;
+        }
+        depth--;
+        median_to_front(items, n, cmp, ctx);
+        size_t split = partition(items, n, cmp, ctx) + 1;
+        if (k < split) {
+            n = split;
+        } else {
+            items += split;
+            n -= split;
+            k -= split;
+        }
+    }
+    insertion_sort(items, n, cmp, ctx);
+}
+
+static void multiselect_loop(void **items, size_t n, size_t base,
+                             const size_t *ranks, size_t nranks,
+                             size_t depth, CompareFuncCtx cmp, void *ctx) {
+    while (nranks > 0) {
+        if (n <= INTRO_SMALL) {
+            insertion_sort(items, n, cmp, ctx);
+            return;
+        }
+        if (depth == 0) {
+            heap_sort(items, n, cmp, ctx);
+            return;
+        }
+        depth--;
+        median_to_front(items, n, cmp, ctx);
+        size_t split = partition(items, n, cmp, ctx) + 1;
+
+        // Ranks left of the split go one way, the rest the other
+        size_t left = 0;
+        while (left < nranks && ranks[left] - base < split) {
+            left++;
+        }
+        if (left < nranks - left) {
+            multiselect_loop(items, split, base, ranks, left, depth, cmp, ctx);
+            items += split;
+            n -= split;
+            base += split;
+            ranks += left;
+            nranks -= left;
+        } else {
+            multiselect_loop(items + split, n - split, base + split,
+                             ranks + left, nranks - left, depth, cmp, ctx);
+            n = split;
+            nranks = left;
+        }
+    }
+}
+
+/**
+ * @brief Place several ranks at once, see lab_introselect().
+ */
+void lab_multiselect(void **items, size_t n, const size_t *ranks, size_t nranks,
+                     CompareFuncCtx cmp, void *ctx) {
+    if (n < 2) return;
+    multiselect_loop(items, n, 0, ranks, nranks, intro_depth(n), cmp, ctx);
+}
+
+/* === Prebuilt pdqsort instantiations === */
+
+LIST_DEFINE_SORT(pdq_int_desc, ListIntKey, (a).key > (b).key)
+LIST_DEFINE_SORT(pdq_str_asc, const char *, strcmp(a, b) < 0)
+LIST_DEFINE_SORT(pdq_arena_str_asc, const char *, lab_arena_strcmp(a, b) < 0)
+
+/*
+ * An arena string's prefix copied next to its pointer, so most comparisons
+ * are decided without touching the string at all.
+ */
+typedef struct {
+    uint64_t prefix;
+    const char *str;
+    size_t index;   // position before sorting, breaks ties
+} ArenaStrKey;
+
+static inline bool arena_key_less(const ArenaStrKey *a, const ArenaStrKey *b) {
+    if (a->prefix != b->prefix) return a->prefix < b->prefix;
+    int r = lab_arena_strcmp_tail(a->str, b->str, a->prefix);
+    return r < 0 || (r == 0 && a->index < b->index);
+}
+
+LIST_DEFINE_SORT(pdq_arena_key_asc, ArenaStrKey, arena_key_less(&(a), &(b)))
+
+/*
+ * Keys for lab_stable_sort(): equal elements are ordered by their position
+ * before sorting. The int index fits in the padding after the key.
+ */
+typedef struct {
+    int key;
+    uint32_t index;
+    void *data;
+} IntRankKey;
+
+typedef struct {
+    const char *str;
+    size_t index;
+} StrRankKey;
+
+static inline bool str_rank_less(const StrRankKey *a, const StrRankKey *b) {
+    int r = strcmp(a->str, b->str);
+    return r < 0 || (r == 0 && a->index < b->index);
+}
+
+LIST_DEFINE_SORT(pdq_int_rank_desc, IntRankKey, (a).key > (b).key || ((a).key == (b).key && (a).index < (b).index))
+LIST_DEFINE_SORT(pdq_str_rank_asc, StrRankKey, str_rank_less(&(a), &(b)))
+
+/**
+ * @brief Sort an array of element pointers, using the inlined pdqsorts for
+ * compare_int, compare_str and compare_arena_str and introsort for anything
+ * else.
+ */
+void lab_sort_items(void **items, size_t n, CompareFunc cmp) {
+    if (n < 2) return;
+
+    // Sorting copies of the keys avoids a cache miss per comparison
+    ListIntKey *keys = cmp == compare_int ? malloc(sizeof(ListIntKey) * n) : NULL;
+    ArenaStrKey *prefixes = cmp == compare_arena_str ? malloc(sizeof(ArenaStrKey) * n) : NULL;
+    if (keys) {
+        for (size_t i = 0; i < n; i++) {
+            keys[i] = (ListIntKey){ *(const int *)items[i], items[i] };
+        }
+        pdq_int_desc(keys, n);
+        for (size_t i = 0; i < n; i++) {
+            items[i] = keys[i].data;
+        }
+        free(keys);
+    } else if (cmp == compare_str) {
+        pdq_str_asc((const char **)items, n);
+    } else if (prefixes) {
+        for (size_t i = 0; i < n; i++) {
+            prefixes[i] = (ArenaStrKey){ lab_arena_prefix(items[i]), items[i], i };
+        }
+        pdq_arena_key_asc(prefixes, n);
+        for (size_t i = 0; i < n; i++) {
+            items[i] = (void *)prefixes[i].str;
+        }
+        free(prefixes);
+    } else if (cmp == compare_arena_str) {
+        pdq_arena_str_asc((const char **)items, n);
+    } else {
+        lab_introsort(items, n, lab_plain_compare, &(PlainCompare){ cmp });
+    }
+}
+
+/*
+ * Compare function context for sorting pointers to array slots: the slots'
+ * elements are compared, and ties go to the earlier slot.
+ */
+typedef struct {
+    CompareFuncCtx cmp;
+    void *ctx;
+} SlotCompare;
+
+static int compare_slots(const void *a, const void *b, void *ctx) {
+    const SlotCompare *slots = ctx;
+    int r = slots->cmp(*(void *const *)a, *(void *const *)b, slots->ctx);
+    if (r != 0) return r;
+    return ((const char *)a > (const char *)b) - ((const char *)a < (const char *)b);
+}
+
+/**
+ * @brief Sort an array of element pointers, keeping equal elements in order.
+ */
+bool lab_stable_sort(void **items, size_t n, CompareFuncCtx cmp, void *ctx, CompareFunc plain) {
+    if (n < 2) return true;
+
+    if (plain == compare_int && n <= UINT32_MAX) {
+        IntRankKey *keys = malloc(sizeof(IntRankKey) * n);
+        if (!keys) return false;
+        for (size_t i = 0; i < n; i++) {
+            keys[i] = (IntRankKey){ *(const int *)items[i], (uint32_t)i, items[i] };
+        }
+        pdq_int_rank_desc(keys, n);
+        for (size_t i = 0; i < n; i++) {
+            items[i] = keys[i].data;
+        }
+        free(keys);
+        return true;
+    }
+    if (plain == compare_str) {
+        StrRankKey *keys = malloc(sizeof(StrRankKey) * n);
+        if (!keys) return false;
+        for (size_t i = 0; i < n; i++) {
+            keys[i] = (StrRankKey){ items[i], i };
+        }
+        pdq_str_rank_asc(keys, n);
+        for (size_t i = 0; i < n; i++) {
+            items[i] = (void *)keys[i].str;
+        }
+        free(keys);
+        return true;
+    }
+    if (plain == compare_arena_str) {
+        ArenaStrKey *keys = malloc(sizeof(ArenaStrKey) * n);
+        if (!keys) return false;
+        for (size_t i = 0; i < n; i++) {
+            keys[i] = (ArenaStrKey){ lab_arena_prefix(items[i]), items[i], i };
+        }
+        pdq_arena_key_asc(keys, n);
+        for (size_t i = 0; i < n; i++) {
+            items[i] = (void *)keys[i].str;
+        }
+        free(keys);
+        return true;
+    }
+
+    // Sort pointers to the slots, whose addresses give the original order
+    void **slots = malloc(sizeof(void *) * n);
+    if (!slots) return false;
+    for (size_t i = 0; i < n; i++) {
+        slots[i] = &items[i];
+    }
+    lab_introsort(slots, n, compare_slots, &(SlotCompare){ cmp, ctx });
+    for (size_t i = 0; i < n; i++) {
+        slots[i] = *(void **)slots[i];
+    }
+    memcpy(items, slots, sizeof(void *) * n);
+    free(slots);
+    return true;
+}
+
+/**
+ * @brief Sort int keys in descending order, the order of compare_int.
+ */
+void list_sort_int_keys_desc(ListIntKey *keys, size_t n) {
+    pdq_int_desc(keys, n);
+}
+
+/**
+ * @brief Sort C strings in ascending strcmp order, the order of compare_str.
+ */
+void list_sort_strs_asc(const char **strs, size_t n) {
+    pdq_str_asc(strs, n);
+}
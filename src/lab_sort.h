@@ -0,0 +1,346 @@
+#ifndef LAB_SORT_H
+#define LAB_SORT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @file lab_sort.h
+ * @brief Generator for pattern-defeating quicksorts specialized to one element
+ * type and one comparison expression.
+ *
+ * CompareFunc is called through a pointer, so the compiler can never inline
+ * compare_int or compare_str into sort(). LIST_DEFINE_SORT instead emits a
+ * pdqsort (Orson Peters' pattern-defeating quicksort) in which the
+ * comparison is an ordinary expression, so it is inlined and the block
+ * partition step compiles to branchless code for simple keys.
+ *
+ * Typical use is on keys spilled out of a list into an array:
+ * @code
+ * typedef struct { double weight; void *data; } WeightKey;
+ * LIST_DEFINE_SORT(sort_by_weight, WeightKey, (a).weight < (b).weight)
+ * ...
+ * sort_by_weight(keys, n);
+ * @endcode
+ */
+
+// Ranges shorter than this are insertion sorted
+#define LIST_SORT_INSERTION 24
+// Ranges longer than this pick the pivot with Tukey's ninther
+#define LIST_SORT_NINTHER 128
+// Elements classified per block in the branchless partition (must fit in a byte)
+#define LIST_SORT_BLOCK 64
+// Moves allowed before an optimistic insertion sort gives up
+#define LIST_SORT_PARTIAL_LIMIT 8
+
+/**
+ * @def LIST_DEFINE_SORT(name, type, less)
+ * @brief Define `static inline void name(type *v, size_t n)`, an unstable in-place sort.
+ * @param name Name of the generated sort function; helpers are prefixed name_.
+ * @param type Element type; elements are copied by value while sorting.
+ * @param less Expression in the elements `a` and `b` (both of type `type`)
+ * that is true when a must come before b. It must be a strict weak ordering.
+ */
+#define LIST_DEFINE_SORT(name, type, less) \
+static inline bool name##_less(type a, type b) { return (less); }                                                          \
+static inline void name##_swap(type *x, type *y) { type tmp = *x; *x = *y; *y = tmp; }                                     \
+static inline void name##_sort2(type *x, type *y) { if (name##_less(*y, *x)) name##_swap(x, y); }                          \
+static inline void name##_sort3(type *x, type *y, type *z) { name##_sort2(x, y); name##_sort2(y, z); name##_sort2(x, y); } \
+/* Insertion sort of [begin, end). */                                                                                      \
+static inline void name##_insertion(type *begin, type *end) {                                                              \
+    if (begin == end) return;                                                                                              \
+    for (type *cur = begin + 1; cur != end; ++cur) {                                                                       \
+        type *sift = cur;                                                                                                  \
+        type *sift_1 = cur - 1;                                                                                            \
+        if (name##_less(*sift, *sift_1)) {                                                                                 \
+            type tmp = *sift;                                                                                              \
+            do { *sift-- = *sift_1; } while (sift != begin && name##_less(tmp, *--sift_1));                                \
+            *sift = tmp;                                                                                                   \
+        }                                                                                                                  \
+    }                                                                                                                      \
+}                                                                                                                          \
+/* Insertion sort that relies on *(begin - 1) being <= every element. */                                                   \
+static inline void name##_unguarded_insertion(type *begin, type *end) {                                                    \
+    if (begin == end) return;                                                                                              \
+    for (type *cur = begin + 1; cur != end; ++cur) {                                                                       \
+        type *sift = cur;                                                                                                  \
+        type *sift_1 = cur - 1;                                                                                            \
+        if (name##_less(*sift, *sift_1)) {                                                                                 \
+            type tmp = *sift;                                                                                              \
+            do { *sift-- = *sift_1; } while (name##_less(tmp, *--sift_1));                                                 \
+            *sift = tmp;                                                                                                   \
+        }                                                                                                                  \
+    }                                                                                                                      \
+}                                                                                                                          \
+/* Insertion sort that gives up after LIST_SORT_PARTIAL_LIMIT moves. */                                                    \
+static inline bool name##_partial_insertion(type *begin, type *end) {                                                      \
+    if (begin == end) return true;                                                                                         \
+    size_t limit = 0;                                                                                                      \
+    for (type *cur = begin + 1; cur != end; ++cur) {                                                                       \
+        type *sift = cur;                                                                                                  \
+        type *sift_1 = cur - 1;                                                                                            \
+        if (name##_less(*sift, *sift_1)) {                                                                                 \
+            type tmp = *sift;                                                                                              \
+            do { *sift-- = *sift_1; } while (sift != begin && name##_less(tmp, *--sift_1));                                \
+            *sift = tmp;                                                                                                   \
+            limit += (size_t)(cur - sift);                                                                                 \
+        }                                                                                                                  \
+        if (limit > LIST_SORT_PARTIAL_LIMIT) return false;                                                                 \
+    }                                                                                                                      \
+    return true;                                                                                                           \
+}                                                                                                                          \
+static inline void name##_sift_down(type *v, size_t root, size_t n) {                                                      \
+    for (;;) {                                                                                                             \
+        size_t child = 2 * root + 1;                                                                                       \
+        if (child >= n) return;                                                                                            \
+        if (child + 1 < n && name##_less(v[child], v[child + 1])) child++;                                                 \
+        if (!name##_less(v[root], v[child])) return;                                                                       \
+        name##_swap(&v[root], &v[child]);                                                                                  \
+        root = child;                                                                                                      \
+    }                                                                                                                      \
+}                                                                                                                          \
+static inline void name##_heapsort(type *begin, type *end) {                                                               \
+    size_t n = (size_t)(end - begin);                                                                                      \
+    for (size_t i = n / 2; i-- > 0;) name##_sift_down(begin, i, n);                                                        \
+    for (size_t i = n; i-- > 1;) {                                                                                         \
+        name##_swap(&begin[0], &begin[i]);                                                                                 \
+        name##_sift_down(begin, 0, i);                                                                                     \
+    }                                                                                                                      \
+}                                                                                                                          \
+/* Swap the elements at the recorded offsets of two blocks. */                                                             \
+static inline void name##_swap_offsets(type *first, type *last, const unsigned char *offsets_l,                            \
+                                     const unsigned char *offsets_r, size_t num, bool use_swaps) {                         \
+    if (use_swaps) {                                                                                                       \
+        for (size_t i = 0; i < num; ++i) name##_swap(first + offsets_l[i], last - offsets_r[i]);                           \
+    } else if (num > 0) {                                                                                                  \
+        type *l = first + offsets_l[0];                                                                                    \
+        type *r = last - offsets_r[0];                                                                                     \
+        type tmp = *l;                                                                                                     \
+        *l = *r;                                                                                                           \
+        for (size_t i = 1; i < num; ++i) {                                                                                 \
+            l = first + offsets_l[i];                                                                                      \
+            *r = *l;                                                                                                       \
+            r = last - offsets_r[i];                                                                                       \
+            *l = *r;                                                                                                       \
+        }                                                                                                                  \
+        *r = tmp;                                                                                                          \
+    }                                                                                                                      \
+}                                                                                                                          \
+/* Branchless block partition around *begin; elements equal to the pivot go right. */                                      \
+static inline type *name##_partition_right(type *begin, type *end, bool *already_partitioned) {                            \
+    type pivot = *begin;                                                                                                   \
+    type *first = begin;                                                                                                   \
+    type *last = end;                                                                                                      \
+    while (name##_less(*++first, pivot));                                                                                  \
+    if (first - 1 == begin) {                                                                                              \
+        while (first < last && !name##_less(*--last, pivot));                                                              \
+    } else {                                                                                                               \
+        while (!name##_less(*--last, pivot));                                                                              \
+    }                                                                                                                      \
+    *already_partitioned = first >= last;                                                                                  \
+    if (!*already_partitioned) {                                                                                           \
+        name##_swap(first, last);                                                                                          \
+        ++first;                                                                                                           \
+        unsigned char offsets_l[LIST_SORT_BLOCK];                                                                          \
+        unsigned char offsets_r[LIST_SORT_BLOCK];                                                                          \
+        type *offsets_l_base = first;                                                                                      \
+        type *offsets_r_base = last;                                                                                       \
+        size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;                                                             \
+        while (first < last) {                                                                                             \
+            size_t num_unknown = (size_t)(last - first);                                                                   \
+            size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;                             \
+            size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;                                              \
+            if (left_split >= LIST_SORT_BLOCK) {                                                                           \
+                for (size_t i = 0; i < LIST_SORT_BLOCK; ++i) {                                                             \
+                    offsets_l[num_l] = (unsigned char)i;                                                                   \
+                    num_l += (size_t)!name##_less(*first, pivot);                                                          \
+                    ++first;                                                                                               \
+                }                                                                                                          \
+            } else {                                                                                                       \
+                for (size_t i = 0; i < left_split; ++i) {                                                                  \
+                    offsets_l[num_l] = (unsigned char)i;                                                                   \
+                    num_l += (size_t)!name##_less(*first, pivot);                                                          \
+                    ++first;                                                                                               \
+                }                                                                                                          \
+            }                                                                                                              \
+            if (right_split >= LIST_SORT_BLOCK) {                                                                          \
+                for (size_t i = 0; i < LIST_SORT_BLOCK;) {                                                                 \
+                    offsets_r[num_r] = (unsigned char)++i;                                                                 \
+                    num_r += (size_t)name##_less(*--last, pivot);                                                          \
+                }                                                                                                          \
+            } else {                                                                                                       \
+                for (size_t i = 0; i < right_split;) {                                                                     \
+                    offsets_r[num_r] = (unsigned char)++i;                                                                 \
+                    num_r += (size_t)name##_less(*--last, pivot);                                                          \
+                }                                                                                                          \
+            }                                                                                                              \
+            size_t num = num_l < num_r ? num_l : num_r;                                                                    \
+            name##_swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l,                                       \
+                              offsets_r + start_r, num, num_l == num_r);                                                   \
+            num_l -= num;                                                                                                  \
+            num_r -= num;                                                                                                  \
+            start_l += num;                                                                                                \
+            start_r += num;                                                                                                \
+            if (num_l == 0) { start_l = 0; offsets_l_base = first; }                                                       \
+            if (num_r == 0) { start_r = 0; offsets_r_base = last; }                                                        \
+        }                                                                                                                  \
+        if (num_l) {                                                                                                       \
+            while (num_l--) name##_swap(offsets_l_base + offsets_l[start_l + num_l], --last);                              \
+            first = last;                                                                                                  \
+        }                                                                                                                  \
+        if (num_r) {                                                                                                       \
+            while (num_r--) { name##_swap(offsets_r_base - offsets_r[start_r + num_r], first); ++first; }                  \
+            last = first;                                                                                                  \
+        }                                                                                                                  \
+    }                                                                                                                      \
+    type *pivot_pos = first - 1;                                                                                           \
+    *begin = *pivot_pos;                                                                                                   \
+    *pivot_pos = pivot;                                                                                                    \
+    return pivot_pos;                                                                                                      \
+}                                                                                                                          \
+/* Partition that puts elements equal to the pivot left, used for runs of equal keys. */                                   \
+static inline type *name##_partition_left(type *begin, type *end) {                                                        \
+    type pivot = *begin;                                                                                                   \
+    type *first = begin;                                                                                                   \
+    type *last = end;                                                                                                      \
+    while (name##_less(pivot, *--last));                                                                                   \
+    if (last + 1 == end) {                                                                                                 \
+        while (first < last && !name##_less(pivot, *++first));                                                             \
+    } else {                                                                                                               \
+        while (!name##_less(pivot, *++first));                                                                             \
+    }                                                                                                                      \
+    while (first < last) {                                                                                                 \
+        name##_swap(first, last);                                                                                          \
+        while (name##_less(pivot, *--last));                                                                               \
+        while (!name##_less(pivot, *++first));                                                                             \
+    }                                                                                                                      \
+    type *pivot_pos = last;                                                                                                \
+    *begin = *pivot_pos;                                                                                                   \
+    *pivot_pos = pivot;                                                                                                    \
+    return pivot_pos;                                                                                                      \
+}                                                                                                                          \
+static inline void name##_loop(type *begin, type *end, int bad_allowed, bool leftmost) {                                   \
+    for (;;) {                                                                                                             \
+        size_t size = (size_t)(end - begin);                                                                               \
+        if (size < LIST_SORT_INSERTION) {                                                                                  \
+            if (leftmost) name##_insertion(begin, end);                                                                    \
+            else name##_unguarded_insertion(begin, end);                                                                   \
+            return;                                                                                                        \
+        }                                                                                                                  \
+        size_t s2 = size / 2;                                                                                              \
+        if (size > LIST_SORT_NINTHER) {                                                                                    \
+            name##_sort3(begin, begin + s2, end - 1);                                                                      \
+            name##_sort3(begin + 1, begin + (s2 - 1), end - 2);                                                            \
+            name##_sort3(begin + 2, begin + (s2 + 1), end - 3);                                                            \
+            name##_sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1));                                                  \
+            name##_swap(begin, begin + s2);                                                                                \
+        } else {                                                                                                           \
+            name##_sort3(begin + s2, begin, end - 1);                                                                      \
+        }                                                                                                                  \
+        if (!leftmost && !name##_less(*(begin - 1), *begin)) {                                                             \
+            begin = name##_partition_left(begin, end) + 1;                                                                 \
+            continue;                                                                                                      \
+        }                                                                                                                  \
+        bool already_partitioned;                                                                                          \
+        type *pivot_pos = name##_partition_right(begin, end, &already_partitioned);                                        \
+        size_t l_size = (size_t)(pivot_pos - begin);                                                                       \
+        size_t r_size = (size_t)(end - (pivot_pos + 1));                                                                   \
+        if (l_size < size / 8 || r_size < size / 8) {                                                                      \
+            if (--bad_allowed == 0) {                                                                                      \
+                name##_heapsort(begin, end);                                                                               \
+                return;                                                                                                    \
+            }                                                                                                              \
+            if (l_size >= LIST_SORT_INSERTION) {                                                                           \
+                name##_swap(begin, begin + l_size / 4);                                                                    \
+                name##_swap(pivot_pos - 1, pivot_pos - l_size / 4);                                                        \
+                if (l_size > LIST_SORT_NINTHER) {                                                                          \
+                    name##_swap(begin + 1, begin + (l_size / 4 + 1));                                                      \
+                    name##_swap(begin + 2, begin + (l_size / 4 + 2));                                                      \
+                    name##_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));                                              \
+                    name##_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));                                              \
+                }                                                                                                          \
+            }                                                                                                              \
+            if (r_size >= LIST_SORT_INSERTION) {                                                                           \
+                name##_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));                                                  \
+                name##_swap(end - 1, end - r_size / 4);                                                                    \
+                if (r_size > LIST_SORT_NINTHER) {                                                                          \
+                    name##_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));                                              \
+                    name##_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));                                              \
+                    name##_swap(end - 2, end - (1 + r_size / 4));                                                          \
+                    name##_swap(end - 3, end - (2 + r_size / 4));                                                          \
+                }                                                                                                          \
+            }                                                                                                              \
+        } else if (already_partitioned && name##_partial_insertion(begin, pivot_pos) &&                                    \
+                   name##_partial_insertion(pivot_pos + 1, end)) {                                                         \
+            return;                                                                                                        \
+        }                                                                                                                  \
+        name##_loop(begin, pivot_pos, bad_allowed, leftmost);                                                              \
+        begin = pivot_pos + 1;                                                                                             \
+        leftmost = false;                                                                                                  \
+    }                                                                                                                      \
+}                                                                                                                          \
+/* Sort v[0..n) in place. */                                                                                               \
+static inline void name(type *v, size_t n) {                                                                               \
+    int bad_allowed = 1;                                                                                                   \
+    for (size_t m = n; m > 1; m >>= 1) bad_allowed++;                                                                      \
+    name##_loop(v, v + n, bad_allowed, true);                                                                              \
+}
+
+/**
+ * @struct ListIntKey
+ * @brief An int key spilled from a list together with the element it came from.
+ */
+typedef struct {
+    int key;
+    void *data;
+} ListIntKey;
+
+/**
+ * @brief Sort int keys in descending order, the order of compare_int.
+ * @param keys Array of n keys.
+ * @param n Number of keys.
+ */
+void list_sort_int_keys_desc(ListIntKey *keys, size_t n);
+
+/**
+ * @brief Sort C strings in ascending strcmp order, the order of compare_str.
+ * @param strs Array of n string pointers.
+ * @param n Number of strings.
+ */
+void list_sort_strs_asc(const char **strs, size_t n);
+
+/**
+ * @enum ListSimdLevel
+ * @brief Instruction set used by the int sorting kernels.
+ */
+typedef enum {
+    LIST_SIMD_SCALAR,   /**< Plain C (pdqsort). */
+    LIST_SIMD_SSE4,     /**< SSE4.1 4-lane networks, 16-int tiles. */
+    LIST_SIMD_AVX2      /**< AVX2 8-lane networks, 64-int tiles. */
+} ListSimdLevel;
+
+/**
+ * @brief Best SIMD level supported by the CPU, detected with cpuid.
+ */
+ListSimdLevel list_simd_level(void);
+
+/**
+ * @brief Cap the SIMD level the int kernels may use (default LIST_SIMD_AVX2).
+ * Intended for benchmarking and testing the fallbacks; affects all threads.
+ * @param max Highest level to use.
+ * @return The previous cap.
+ */
+ListSimdLevel list_simd_limit(ListSimdLevel max);
+
+/**
+ * @brief Sort ints in descending order (the order of compare_int).
+ * Tiles of 64 (AVX2) or 16 (SSE4.1) keys are sorted in registers with a
+ * sorting network and in-register bitonic merges, then combined with a
+ * vectorized bitonic merge. Without SIMD support this is a pdqsort.
+ * @param keys Array of n ints.
+ * @param n Number of ints.
+ * @return true on success, false if scratch memory could not be allocated.
+ */
+bool list_sort_ints_desc(int *keys, size_t n);
+
+#endif // LAB_SORT_H
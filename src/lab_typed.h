@@ -0,0 +1,223 @@
+#ifndef LAB_TYPED_H
+#define LAB_TYPED_H
+
+#include "lab_sort.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+/**
+ * @file lab_typed.h
+ * @brief Generator for doubly linked lists that store one element type by value.
+ *
+ * The generic List stores void pointers, so every int has to be boxed and
+ * every comparison goes through a CompareFunc pointer. LIST_DEFINE emits a
+ * list with the same circular sentinel design in which each node holds a
+ * `type` directly, nodes are carved from blocks of growing size, and
+ * sorting uses a LIST_DEFINE_SORT pdqsort so the comparison is inlined.
+ *
+ * @code
+ * LIST_DEFINE(intlist, int, (a) < (b))
+ * ...
+ * intlist *l = intlist_create();
+ * intlist_append(l, 5);
+ * intlist_sort(l);
+ * for (intlist_node *n = intlist_begin(l); n != intlist_end(l); n = n->next) {
+ *     use(n->value);
+ * }
+ * intlist_destroy(l);
+ * @endcode
+ */
+
+// First block of a list holds this many nodes, later ones double up to the max
+#define LIST_TYPED_BLOCK_MIN 16
+#define LIST_TYPED_BLOCK_MAX 65536
+
+/**
+ * @def LIST_DEFINE(name, type, less)
+ * @brief Define the list type `name`, its node type `name_node` and the
+ * static inline functions below, all prefixed `name_`.
+ *
+ * - `name *name_create(void)`, `void name_destroy(name *)`
+ * - `bool name_append(name *, type)`, `bool name_prepend(name *, type)`,
+ *   `bool name_insert(name *, size_t index, type)`
+ * - `bool name_remove(name *, size_t index, type *out)`,
+ *   `type *name_get(name *, size_t index)`, `size_t name_size(const name *)`
+ * - `name_node *name_begin(name *)`, `name_node *name_end(name *)`
+ * - `bool name_sort(name *)` (not stable), `bool name_is_sorted(const name *)`,
+ *   `name *name_merge(const name *, const name *)` (new list, stable)
+ *
+ * Functions returning bool return false on allocation failure or a bad index.
+ * Removed nodes are reused by later insertions; memory is only returned by
+ * name_destroy().
+ * @param name Name of the list type and prefix of everything generated.
+ * @param type Element type, copied by value.
+ * @param less Expression in the elements `a` and `b` (both of type `type`)
+ * that is true when a must come before b. It must be a strict weak ordering.
+ */
+#define LIST_DEFINE(name, type, less) \
+LIST_DEFINE_SORT(name##_sort_values, type, less)                                                                           \
+typedef struct name##_node {                                                                                               \
+    struct name##_node *next;                                                                                              \
+    struct name##_node *prev;                                                                                              \
+    type value;                                                                                                            \
+} name##_node;                                                                                                             \
+typedef struct name##_block {                                                                                              \
+    struct name##_block *next;                                                                                             \
+    name##_node nodes[];                                                                                                   \
+} name##_block;                                                                                                            \
+typedef struct {                                                                                                           \
+    name##_node sentinel;     /* value unused */                                                                           \
+    size_t size;                                                                                                           \
+    name##_block *blocks;                                                                                                  \
+    name##_node *free_nodes;  /* singly linked through next */                                                             \
+    name##_node *bump;        /* unused tail of the newest block */                                                        \
+    size_t bump_left;                                                                                                      \
+    size_t grow;              /* node count of the next block */                                                           \
+} name;                                                                                                                    \
+/* Create an empty list, NULL on failure. */                                                                               \
+static inline name *name##_create(void) {                                                                                  \
+    name *list = (name *)calloc(1, sizeof(name));                                                                          \
+    if (list == NULL) return NULL;                                                                                         \
+    list->sentinel.next = &list->sentinel;                                                                                 \
+    list->sentinel.prev = &list->sentinel;                                                                                 \
+    list->grow = LIST_TYPED_BLOCK_MIN;                                                                                     \
+    return list;                                                                                                           \
+}                                                                                                                          \
+/* Free the list and all of its nodes. */                                                                                  \
+static inline void name##_destroy(name *list) {                                                                            \
+    if (list == NULL) return;                                                                                              \
+    name##_block *block = list->blocks;                                                                                    \
+    while (block != NULL) {                                                                                                \
+        name##_block *next = block->next;                                                                                  \
+        free(block);                                                                                                       \
+        block = next;                                                                                                      \
+    }                                                                                                                      \
+    free(list);                                                                                                            \
+}                                                                                                                          \
+static inline name##_node *name##_node_alloc(name *list) {                                                                 \
+    name##_node *node = list->free_nodes;                                                                                  \
+    if (node != NULL) {                                                                                                    \
+        list->free_nodes = node->next;                                                                                     \
+        return node;                                                                                                       \
+    }                                                                                                                      \
+    if (list->bump_left == 0) {                                                                                            \
+        name##_block *block = (name##_block *)malloc(sizeof(name##_block) + sizeof(name##_node) * list->grow);             \
+        if (block == NULL) return NULL;                                                                                    \
+        block->next = list->blocks;                                                                                        \
+        list->blocks = block;                                                                                              \
+        list->bump = block->nodes;                                                                                         \
+        list->bump_left = list->grow;                                                                                      \
+        if (list->grow < LIST_TYPED_BLOCK_MAX) list->grow *= 2;                                                            \
+    }                                                                                                                      \
+    list->bump_left--;                                                                                                     \
+    return list->bump++;                                                                                                   \
+}                                                                                                                          \
+static inline void name##_link_before(name *list, name##_node *at, name##_node *node) {                                    \
+    node->next = at;                                                                                                       \
+    node->prev = at->prev;                                                                                                 \
+    at->prev->next = node;                                                                                                 \
+    at->prev = node;                                                                                                       \
+    list->size++;                                                                                                          \
+}                                                                                                                          \
+/* First node, or the sentinel (name_end()) when empty; walk with ->next. */                                               \
+static inline name##_node *name##_begin(name *list) { return list->sentinel.next; }                                        \
+static inline name##_node *name##_end(name *list) { return &list->sentinel; }                                              \
+static inline size_t name##_size(const name *list) { return list->size; }                                                  \
+/* Node at index (index == size gives the sentinel), walking from the closer end. */                                       \
+static inline name##_node *name##_node_at(name *list, size_t index) {                                                      \
+    name##_node *cur = &list->sentinel;                                                                                    \
+    if (index < list->size / 2) {                                                                                          \
+        for (size_t i = 0; i <= index; i++) cur = cur->next;                                                               \
+    } else {                                                                                                               \
+        for (size_t i = list->size; i > index; i--) cur = cur->prev;                                                       \
+    }                                                                                                                      \
+    return cur;                                                                                                            \
+}                                                                                                                          \
+static inline bool name##_append(name *list, type value) {                                                                 \
+    name##_node *node = name##_node_alloc(list);                                                                           \
+    if (node == NULL) return false;                                                                                        \
+    node->value = value;                                                                                                   \
+    name##_link_before(list, &list->sentinel, node);                                                                       \
+    return true;                                                                                                           \
+}                                                                                                                          \
+static inline bool name##_prepend(name *list, type value) {                                                                \
+    name##_node *node = name##_node_alloc(list);                                                                           \
+    if (node == NULL) return false;                                                                                        \
+    node->value = value;                                                                                                   \
+    name##_link_before(list, list->sentinel.next, node);                                                                   \
+    return true;                                                                                                           \
+}                                                                                                                          \
+static inline bool name##_insert(name *list, size_t index, type value) {                                                   \
+    if (index > list->size) return false;                                                                                  \
+    name##_node *node = name##_node_alloc(list);                                                                           \
+    if (node == NULL) return false;                                                                                        \
+    node->value = value;                                                                                                   \
+    name##_link_before(list, name##_node_at(list, index), node);                                                           \
+    return true;                                                                                                           \
+}                                                                                                                          \
+/* Remove the element at index, storing it in *out unless out is NULL. */                                                  \
+static inline bool name##_remove(name *list, size_t index, type *out) {                                                    \
+    if (index >= list->size) return false;                                                                                 \
+    name##_node *node = name##_node_at(list, index);                                                                       \
+    if (out != NULL) *out = node->value;                                                                                   \
+    node->prev->next = node->next;                                                                                         \
+    node->next->prev = node->prev;                                                                                         \
+    node->next = list->free_nodes;                                                                                         \
+    list->free_nodes = node;                                                                                               \
+    list->size--;                                                                                                          \
+    return true;                                                                                                           \
+}                                                                                                                          \
+/* Pointer to the element at index, NULL if out of range. */                                                               \
+static inline type *name##_get(name *list, size_t index) {                                                                 \
+    if (index >= list->size) return NULL;                                                                                  \
+    return &name##_node_at(list, index)->value;                                                                            \
+}                                                                                                                          \
+/* Sort by less: values are spilled, sorted with the inlined pdqsort and written back. */                                  \
+static inline bool name##_sort(name *list) {                                                                               \
+    if (list->size < 2) return true;                                                                                       \
+    type *values = (type *)malloc(sizeof(type) * list->size);                                                              \
+    if (values == NULL) return false;                                                                                      \
+    size_t i = 0;                                                                                                          \
+    for (name##_node *cur = list->sentinel.next; cur != &list->sentinel; cur = cur->next) {                                \
+        values[i++] = cur->value;                                                                                          \
+    }                                                                                                                      \
+    name##_sort_values(values, list->size);                                                                                \
+    i = 0;                                                                                                                 \
+    for (name##_node *cur = list->sentinel.next; cur != &list->sentinel; cur = cur->next) {                                \
+        cur->value = values[i++];                                                                                          \
+    }                                                                                                                      \
+    free(values);                                                                                                          \
+    return true;                                                                                                           \
+}                                                                                                                          \
+static inline bool name##_is_sorted(const name *list) {                                                                    \
+    const name##_node *cur = list->sentinel.next;                                                                          \
+    for (; cur != &list->sentinel && cur->next != &list->sentinel; cur = cur->next) {                                      \
+        if (name##_sort_values_less(cur->next->value, cur->value)) return false;                                           \
+    }                                                                                                                      \
+    return true;                                                                                                           \
+}                                                                                                                          \
+/* Merge two sorted lists into a new one, ties taken from a first; NULL on failure. */                                     \
+static inline name *name##_merge(const name *a, const name *b) {                                                           \
+    name *out = name##_create();                                                                                           \
+    if (out == NULL) return NULL;                                                                                          \
+    const name##_node *x = a->sentinel.next;                                                                               \
+    const name##_node *y = b->sentinel.next;                                                                               \
+    bool ok = true;                                                                                                        \
+    while (ok && (x != &a->sentinel || y != &b->sentinel)) {                                                               \
+        if (y == &b->sentinel || (x != &a->sentinel && !name##_sort_values_less(y->value, x->value))) {                    \
+            ok = name##_append(out, x->value);                                                                             \
+            x = x->next;                                                                                                   \
+        } else {                                                                                                           \
+            ok = name##_append(out, y->value);                                                                             \
+            y = y->next;                                                                                                   \
+        }                                                                                                                  \
+    }                                                                                                                      \
+    if (!ok) {                                                                                                             \
+        name##_destroy(out);                                                                                               \
+        return NULL;                                                                                                       \
+    }                                                                                                                      \
+    return out;                                                                                                            \
+}
+
+#endif // LAB_TYPED_H
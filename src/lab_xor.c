@@ -0,0 +1,184 @@
+#include "lab_internal.h"
+#include <stdlib.h>
+
+// First block of a list holds this many nodes, later ones double up to the max
+#define XOR_BLOCK_MIN 16
+#define XOR_BLOCK_MAX 65536
+
+/* === Nodes === */
+
+/**
+ * @brief Set up an empty list: the sentinel links to itself twice, which
+ * XORs to 0.
+ */
+void lab_xor_init(XorPool *pool) {
+    *pool = (XorPool){ 0 };
+    pool->first = &pool->sentinel;
+}
+
+/**
+ * @brief Free the element of every linked node (if free_func is set) and
+ * every block.
+ */
+void lab_xor_release(XorPool *pool, FreeFunc free_func) {
+    if (!pool->first) return;
+    if (free_func) {
+        XorNode *prev = &pool->sentinel;
+        for (XorNode *cur = pool->first; cur != &pool->sentinel;) {
+            if (cur->data) {
+                free_func(cur->data);
+            }
+            XorNode *next = xor_step(cur, prev);
+            prev = cur;
+            cur = next;
+        }
+    }
+    XorBlock *block = pool->blocks;
+    while (block) {
+        XorBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    *pool = (XorPool){ 0 };
+}
+
+/**
+ * @brief Take a node, reusing a freed one if possible.
+ * @return The node, or NULL on failure.
+ */
+static XorNode *xor_alloc(XorPool *pool) {
+    if (pool->free_nodes) {
+        XorNode *node = pool->free_nodes;
+        pool->free_nodes = (XorNode *)node->link;
+        return node;
+    }
+    if (pool->bump_left == 0) {
+        if (pool->grow < XOR_BLOCK_MIN) {
+            pool->grow = XOR_BLOCK_MIN;
+        }
+        XorBlock *block = malloc(sizeof(XorBlock) + sizeof(XorNode) * pool->grow);
+        if (!block) return NULL;
+        block->next = pool->blocks;
+        pool->blocks = block;
+        pool->bump = block->nodes;
+        pool->bump_left = pool->grow;
+        if (pool->grow < XOR_BLOCK_MAX) {
+            pool->grow *= 2;
+        }
+    }
+    pool->bump_left--;
+    return pool->bump++;
+}
+
+/**
+ * @brief Give an unlinked node back for reuse.
+ */
+static void xor_free(XorPool *pool, XorNode *node) {
+    node->data = NULL;
+    node->link = (uintptr_t)pool->free_nodes;
+    pool->free_nodes = node;
+}
+
+/**
+ * @brief Node at index and the node before it, index == size gives the
+ * sentinel. Walks from whichever end is closer.
+ */
+static XorNode *xor_at(const List *list, size_t index, XorNode **before) {
+    XorNode *sentinel = (XorNode *)&list->xor_pool.sentinel;
+    XorNode *prev;
+    XorNode *cur;
+    if (index < list->size / 2) {
+        prev = sentinel;
+        cur = list->xor_pool.first;
+        for (size_t i = 0; i < index; i++) {
+            XorNode *next = xor_step(cur, prev);
+            prev = cur;
+            cur = next;
+        }
+    } else {
+        cur = sentinel;
+        prev = xor_step(sentinel, list->xor_pool.first);
+        for (size_t i = list->size; i > index; i--) {
+            XorNode *back = xor_step(prev, cur);
+            cur = prev;
+            prev = back;
+        }
+    }
+    *before = prev;
+    return cur;
+}
+
+/**
+ * @brief Link node in between the neighbours before and after.
+ */
+static void xor_link(XorNode *node, XorNode *before, XorNode *after) {
+    node->link = (uintptr_t)before ^ (uintptr_t)after;
+    before->link ^= (uintptr_t)after ^ (uintptr_t)node;
+    after->link ^= (uintptr_t)before ^ (uintptr_t)node;
+}
+
+/* === Element access === */
+
+/**
+ * @brief Insert n elements so that the first of them ends up at index.
+ */
+bool lab_xor_insert(List *list, size_t index, void *const *items, size_t n) {
+    XorPool *pool = &list->xor_pool;
+
+    // Nodes are taken first so a failure leaves the list unchanged
+    XorNode *one;
+    XorNode **nodes = n == 1 ? &one : malloc(sizeof(XorNode *) * n);
+    if (!nodes) return false;
+    for (size_t i = 0; i < n; i++) {
+        nodes[i] = xor_alloc(pool);
+        if (!nodes[i]) {
+            while (i-- > 0) {
+                xor_free(pool, nodes[i]);
+            }
+            if (nodes != &one) free(nodes);
+            return false;
+        }
+    }
+
+    XorNode *before;
+    XorNode *after = xor_at(list, index, &before);
+    for (size_t i = 0; i < n; i++) {
+        nodes[i]->data = items[i];
+        xor_link(nodes[i], before, after);
+        before = nodes[i];
+    }
+    if (index == 0) {
+        pool->first = nodes[0];
+    }
+    list->size += n;
+
+    if (nodes != &one) free(nodes);
+    return true;
+}
+
+/**
+ * @brief Unlink the element at index and give its node back.
+ */
+void *lab_xor_remove(List *list, size_t index) {
+    XorNode *before;
+    XorNode *node = xor_at(list, index, &before);
+    XorNode *after = xor_step(node, before);
+    before->link ^= (uintptr_t)node ^ (uintptr_t)after;
+    after->link ^= (uintptr_t)node ^ (uintptr_t)before;
+    if (list->xor_pool.first == node) {
+        list->xor_pool.first = after;
+    }
+
+    void *data = node->data;
+    xor_free(&list->xor_pool, node);
+    list->size--;
+    return data;
+}
+
+/**
+ * @brief Element at index, which must be below size.
+ */
+void *lab_xor_get(const List *list, size_t index) {
+    XorNode *before;
+    return xor_at(list, index, &before)->data;
+}
@@ -1,145 +1,401 @@
 #include "lab.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <time.h>
+#include <unistd.h>
 
 /* === Utility: Random data generation === */
 
-static char *random_string(int min_len, int max_len) {
+// Longest string random_string() makes
+#define RANDOM_STRING_MAX 64
+
+static const char *random_string(StringArena *arena, int min_len, int max_len) {
     int len = min_len + rand() % (max_len - min_len + 1);
-    char *s = malloc((size_t)len + 1);
-    if (!s) return NULL;
+    char s[RANDOM_STRING_MAX];
 
     for (int i = 0; i < len; i++) {
         s[i] = (char)('a' + (rand() % 26));
     }
-    s[len] = '\0';
-    return s;
+    return string_arena_add(arena, s, (size_t)len);
+}
+
+/* === Utility: Newline-delimited input === */
+
+// Size of a single read() when the input size is not known up front
+#define READ_BLOCK_BYTES ((size_t)1 << 20)
+
+/**
+ * @brief Read all of fd into one buffer with large block reads.
+ * Regular files are read into a buffer of their exact size; pipes grow the
+ * buffer geometrically. A full buffer is only grown once a small probe read
+ * shows there is more input. One spare byte is left for a terminator.
+ * @return The buffer (caller frees), or NULL on failure.
+ */
+static char *read_input(int fd, size_t *len) {
+    struct stat st;
+    size_t cap = READ_BLOCK_BYTES;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        cap = (size_t)st.st_size + 1;
+    }
+    char *buf = malloc(cap);
+    *len = 0;
+
+    while (buf) {
+        if (cap - *len < 2) {
+            // Full: look for EOF before doubling, so an exactly sized buffer stays as is
+            char probe[4096];
+            ssize_t got = read(fd, probe, sizeof(probe));
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) {
+                if (got == 0) return buf;
+                break;
+            }
+            size_t grown = cap * 2;
+            while (grown - *len < (size_t)got + 1) {
+                grown *= 2;
+            }
+            char *bigger = realloc(buf, grown);
+            if (!bigger) break;
+            buf = bigger;
+            cap = grown;
+            memcpy(buf + *len, probe, (size_t)got);
+            *len += (size_t)got;
+            continue;
+        }
+        ssize_t got = read(fd, buf + *len, cap - *len - 1);
+        if (got < 0 && errno == EINTR) continue;
+        if (got < 0) break;
+        if (got == 0) return buf;
+        *len += (size_t)got;
+    }
+    free(buf);
+    return NULL;
+}
+
+/**
+ * @brief Split the buffer into lines in place, in a single pass.
+ * Newlines (and a preceding carriage return) become terminators, so every
+ * line is a C string pointing into buf; nothing is copied. A final line
+ * without a newline is kept.
+ * @return Array of *count line pointers (caller frees), or NULL on failure.
+ */
+static char **split_lines(char *buf, size_t len, size_t *count) {
+    size_t cap = len / 16 + 16;
+    size_t n = 0;
+    char **lines = malloc(sizeof(char *) * cap);
+    bool ok = lines != NULL;
+
+    // The spare byte holds a newline so every line has one
+    buf[len] = '\n';
+    char *end = buf + len;
+    for (char *line = buf; ok && line < end; n++) {
+        if (n == cap) {
+            char **bigger = realloc(lines, sizeof(char *) * cap * 2);
+            ok = bigger != NULL;
+            if (!ok) break;
+            lines = bigger;
+            cap *= 2;
+        }
+        char *nl = memchr(line, '\n', (size_t)(end - line) + 1);
+        *nl = '\0';
+        if (nl > line && nl[-1] == '\r') {
+            nl[-1] = '\0';
+        }
+        lines[n] = line;
+        line = nl + 1;
+    }
+    buf[len] = '\0';
+
+    if (!ok) {
+        free(lines);
+        return NULL;
+    }
+    *count = n;
+    return lines;
+}
+
+/**
+ * @brief Parse one decimal int per line straight from the buffer.
+ * Digits are consumed up to the line end, so no separate newline scan or
+ * line array is needed. Lines may end in "\r\n"; a final line without a
+ * newline is kept.
+ * @param bad_line Set to the 1-based number of the first malformed line.
+ * @return Array of *count values (caller frees), or NULL on failure.
+ */
+static int *parse_ints(char *buf, size_t len, size_t *count, size_t *bad_line) {
+    size_t cap = len / 8 + 16;
+    size_t n = 0;
+    int *values = malloc(sizeof(int) * cap);
+    *bad_line = 0;
+
+    // The spare byte holds a newline so every line is terminated
+    buf[len] = '\n';
+    const char *p = buf;
+    const char *end = buf + len;
+    while (values && p < end) {
+        if (n == cap) {
+            int *bigger = realloc(values, sizeof(int) * cap * 2);
+            if (!bigger) break;
+            values = bigger;
+            cap *= 2;
+        }
+        bool neg = *p == '-';
+        if (*p == '-' || *p == '+') p++;
+
+        const char *digits = p;
+        unsigned long long v = 0;
+        while ((unsigned)(*p - '0') < 10 && v <= (unsigned long long)INT_MAX + 1) {
+            v = v * 10 + (unsigned)(*p++ - '0');
+        }
+        bool valid = p > digits && v <= (unsigned long long)INT_MAX + neg;
+        if (*p == '\r') p++;
+        if (!valid || *p != '\n') {
+            *bad_line = n + 1;
+            break;
+        }
+        values[n++] = neg ? (int)-(long long)v : (int)v;
+        p++;
+    }
+
+    if (!values || p < end) {
+        free(values);
+        return NULL;
+    }
+    *count = n;
+    return values;
+}
+
+/* === Utility: Phase timing === */
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void report_phase(const char *phase, double *mark) {
+    double now = now_seconds();
+    fprintf(stderr, "%-8s %10.3f ms\n", phase, (now - *mark) * 1e3);
+    *mark = now;
 }
 
 /* === Sorting task for pthreads === */
 
 typedef struct {
     List *list;
-    size_t start;
-    size_t end;
     CompareFunc cmp;
 } SortTask;
 
 static void *thread_sort(void *arg) {
     SortTask *task = (SortTask *)arg;
-    sort(task->list, task->start, task->end, task->cmp);
-    return NULL;
-}
-
-/* === Verify function === */
-
-static int verify_sorted(const List *list, CompareFunc cmp) {
-    if (!list || !cmp) return 0;
-    if (list_size(list) < 2) return 1;
-
-    for (size_t i = 0; i + 1 < list_size(list); i++) {
-        void *a = list_get(list, i);
-        void *b = list_get(list, i + 1);
-        if (cmp(a, b) > 0) {
-            return 0;
-        }
+    if (list_size(task->list) > 1) {
+        sort(task->list, 0, list_size(task->list) - 1, task->cmp);
     }
-    return 1;
+    return NULL;
 }
 
 /* === Main === */
 #ifndef TEST
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-t threads] [-i file] <int|string> [n]\n", prog);
+    fprintf(stderr, "  -t threads  number of chunks sorted concurrently (default: online CPUs)\n");
+    fprintf(stderr, "  -i file     sort the lines of file ('-' for stdin) instead of n random values\n");
+}
+
 int main(int argc, char *argv[]) {
-    if (argc != 3) {
-        fprintf(stderr, "Usage: %s <int|string> <n>\n", argv[0]);
+    long threads_opt = 0;
+    const char *input_path = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:i:h")) != -1) {
+        switch (opt) {
+        case 'i':
+            input_path = optarg;
+            break;
+        case 't':
+            threads_opt = atol(optarg);
+            if (threads_opt <= 0) {
+                fprintf(stderr, "Thread count must be > 0\n");
+                return EXIT_FAILURE;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (argc - optind != (input_path ? 1 : 2)) {
+        usage(argv[0]);
         return EXIT_FAILURE;
     }
 
     srand((unsigned)time(NULL));
 
-    int is_int = strcmp(argv[1], "int") == 0;
-    int is_string = strcmp(argv[1], "string") == 0;
+    const char *kind = argv[optind];
+    int is_int = strcmp(kind, "int") == 0;
+    int is_string = strcmp(kind, "string") == 0;
     if (!is_int && !is_string) {
         fprintf(stderr, "First argument must be 'int' or 'string'\n");
         return EXIT_FAILURE;
     }
 
-    int n = atoi(argv[2]);
-    if (n <= 0) {
-        fprintf(stderr, "List length must be > 0\n");
-        return EXIT_FAILURE;
+    size_t n = 0;
+    if (!input_path) {
+        int count = atoi(argv[optind + 1]);
+        if (count <= 0) {
+            fprintf(stderr, "List length must be > 0\n");
+            return EXIT_FAILURE;
+        }
+        n = (size_t)count;
     }
 
     CompareFunc cmp = is_int ? compare_int : compare_str;
+    double mark = now_seconds();
 
-    // Create list and fill with random data
-    List *list = list_create(LIST_LINKED_SENTINEL);
-    for (int i = 0; i < n; i++) {
+    // Strings point into the input buffer or the string arena, ints are
+    // gathered in one array and copied into the nodes
+    void **items;
+    char *input = NULL;
+    int *values = NULL;
+    StringArena *arena = NULL;
+    if (input_path) {
+        int fd = strcmp(input_path, "-") == 0 ? STDIN_FILENO : open(input_path, O_RDONLY);
+        size_t len = 0;
+        input = fd >= 0 ? read_input(fd, &len) : NULL;
+        if (fd > STDIN_FILENO) {
+            close(fd);
+        }
+        if (!input) {
+            fprintf(stderr, "Cannot read %s\n", input_path);
+            return EXIT_FAILURE;
+        }
+
+        // Strings stay in the buffer; ints are parsed into one array
+        size_t bad_line = 0;
+        if (is_int) {
+            values = parse_ints(input, len, &n, &bad_line);
+            items = values ? malloc(sizeof(void *) * (n ? n : 1)) : NULL;
+            for (size_t i = 0; items && i < n; i++) {
+                items[i] = &values[i];
+            }
+        } else {
+            items = (void **)split_lines(input, len, &n);
+        }
+        if (bad_line) {
+            fprintf(stderr, "%s:%zu: not an int\n", input_path, bad_line);
+            return EXIT_FAILURE;
+        }
+        if (!items) {
+            fprintf(stderr, "Out of memory\n");
+            return EXIT_FAILURE;
+        }
+        report_phase("read", &mark);
+    } else {
+        // Create random data
+        items = malloc(sizeof(void *) * n);
         if (is_int) {
-            int *val = malloc(sizeof(int));
-            *val = rand() % 1000;
-            list_append(list, val);
+            values = malloc(sizeof(int) * n);
         } else {
-            char *s = random_string(5, 15);
-            list_append(list, s);
+            arena = string_arena_create(false);
+            cmp = compare_arena_str;
         }
+        if (!items || (is_int ? !values : !arena)) {
+            fprintf(stderr, "Out of memory\n");
+            return EXIT_FAILURE;
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (is_int) {
+                values[i] = rand() % 1000;
+                items[i] = &values[i];
+            } else {
+                items[i] = (void *)random_string(arena, 5, 15);
+            }
+        }
+        report_phase("generate", &mark);
     }
 
-    // Split into halves
-    size_t mid = (size_t)n / 2;
-
-    // Sort first half
-    SortTask task1 = { list, 0, mid - 1, cmp };
-    pthread_t t1;
-    pthread_create(&t1, NULL, thread_sort, &task1);
+    size_t nthreads = (size_t)threads_opt;
+    if (nthreads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = cpus > 0 ? (size_t)cpus : 1;
+    }
+    if (nthreads > n) {
+        nthreads = n > 0 ? n : 1;
+    }
 
-    // Sort second half
-    SortTask task2 = { list, mid, (size_t)n - 1, cmp };
-    pthread_t t2;
-    pthread_create(&t2, NULL, thread_sort, &task2);
+    // Build the list in one go, ints are stored in the nodes themselves
+    List *list = is_int ? list_create_inline(sizeof(int)) : list_create(LIST_LINKED_SENTINEL);
+    if (!list || !list_append_many(list, items, n)) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+    free(items);
+    free(values);
+    report_phase("build", &mark);
 
-    pthread_join(t1, NULL);
-    pthread_join(t2, NULL);
+    // Split into one contiguous chain per thread
+    List **chunks = malloc(sizeof(List *) * nthreads);
+    SortTask *tasks = malloc(sizeof(SortTask) * nthreads);
+    pthread_t *workers = malloc(sizeof(pthread_t) * nthreads);
+    if (!chunks || !tasks || !workers || !list_partition(list, nthreads, chunks)) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+    list_destroy(list, NULL);
+    report_phase("split", &mark);
 
-    // Build two sublists for merging
-    List *left = list_create(LIST_LINKED_SENTINEL);
-    for (size_t i = 0; i < mid; i++) {
-        list_append(left, list_get(list, i));
+    // Sort every chunk concurrently
+    for (size_t t = 0; t < nthreads; t++) {
+        tasks[t] = (SortTask){ chunks[t], cmp };
+        pthread_create(&workers[t], NULL, thread_sort, &tasks[t]);
     }
-    List *right = list_create(LIST_LINKED_SENTINEL);
-    for (size_t i = mid; i < (size_t)n; i++) {
-        list_append(right, list_get(list, i));
+    for (size_t t = 0; t < nthreads; t++) {
+        pthread_join(workers[t], NULL);
     }
+    report_phase("sort", &mark);
 
-    // Merge halves
-    List *sorted = merge(left, right, cmp);
+    // Merge all chunks at once
+    List *sorted = list_merge_k(chunks, nthreads, cmp);
+    if (!sorted || (arena && !list_attach_arena(sorted, arena))) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+    string_arena_release(arena);
 
     // Free old containers (but not data)
-    list_destroy(left, NULL);
-    list_destroy(right, NULL);
-    list_destroy(list, NULL);
+    for (size_t t = 0; t < nthreads; t++) {
+        list_destroy(chunks[t], NULL);
+    }
+    free(workers);
+    free(tasks);
+    free(chunks);
+    report_phase("merge", &mark);
 
     // Verify sorted
-    if (verify_sorted(sorted, cmp)) {
+    if (list_is_sorted_parallel(sorted, cmp, nthreads)) {
         printf("List is sorted!\n");
     } else {
         printf("Error: list is not sorted!\n");
     }
+    report_phase("verify", &mark);
 
-    // Print results
-    for (size_t i = 0; i < list_size(sorted); i++) {
-        if (is_int) {
-            printf("%d\n", *(int *)list_get(sorted, i));
-        } else {
-            printf("%s\n", (char *)list_get(sorted, i));
-        }
+    // Print results in one pass over the chain
+    fflush(stdout);
+    if (!list_write(sorted, STDOUT_FILENO, is_int ? list_format_int : list_format_str)) {
+        fprintf(stderr, "Cannot write the sorted list\n");
+        return EXIT_FAILURE;
     }
+    report_phase("print", &mark);
 
     // Cleanup
-    list_destroy(sorted, free);
+    list_destroy_parallel(sorted, NULL, nthreads);
+    free(input);
+    report_phase("cleanup", &mark);
 
     return EXIT_SUCCESS;
 }
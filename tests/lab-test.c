@@ -1,7 +1,16 @@
 #include "../tests/harness/unity.h"
 #include "../src/lab.h"
+#include "../src/lab_sort.h"
+#include "../src/lab_typed.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 /* === Required by Unity === */
 void setUp(void) {}
@@ -27,6 +36,16 @@ static void free_test_object(void *obj) {
     free(obj);
 }
 
+static List *create_random_int_list(size_t n, int max) {
+    List *list = list_create(LIST_LINKED_SENTINEL);
+    for (size_t i = 0; i < n; i++) {
+        int *val = malloc(sizeof(int));
+        *val = rand() % max;
+        list_append(list, val);
+    }
+    return list;
+}
+
 /* === Tests === */
 
 void test_list_create_destroy(void) {
@@ -204,6 +223,181 @@ void test_list_get_null(void) {
     TEST_ASSERT_NULL(list_get(NULL, 100)); // redundant but forces both args
 }
 
+void test_list_split_at(void) {
+    List *list = list_create(LIST_LINKED_SENTINEL);
+    for (int i = 0; i < 10; i++) {
+        list_append(list, create_test_object(i, "split"));
+    }
+
+    List *tail = list_split_at(list, 7);
+    TEST_ASSERT_EQUAL_UINT32(7, list_size(list));
+    TEST_ASSERT_EQUAL_UINT32(3, list_size(tail));
+    TEST_ASSERT_EQUAL_INT(6, ((TestObject *)list_get(list, 6))->id);
+    TEST_ASSERT_EQUAL_INT(7, ((TestObject *)list_get(tail, 0))->id);
+    TEST_ASSERT_EQUAL_INT(9, ((TestObject *)list_get(tail, 2))->id);
+
+    // Split near the front walks forward, both halves stay usable
+    List *rest = list_split_at(list, 2);
+    TEST_ASSERT_EQUAL_UINT32(2, list_size(list));
+    TEST_ASSERT_EQUAL_UINT32(5, list_size(rest));
+    TEST_ASSERT_EQUAL_INT(2, ((TestObject *)list_get(rest, 0))->id);
+    TEST_ASSERT_TRUE(list_append(list, create_test_object(100, "end")));
+    TEST_ASSERT_EQUAL_INT(100, ((TestObject *)list_get(list, 2))->id);
+
+    // Edges: at size gives an empty list, past size fails
+    List *empty = list_split_at(list, list_size(list));
+    TEST_ASSERT_NOT_NULL(empty);
+    TEST_ASSERT_TRUE(list_is_empty(empty));
+    TEST_ASSERT_NULL(list_split_at(list, 50));
+    TEST_ASSERT_NULL(list_split_at(NULL, 0));
+
+    List *all = list_split_at(rest, 0);
+    TEST_ASSERT_TRUE(list_is_empty(rest));
+    TEST_ASSERT_EQUAL_UINT32(5, list_size(all));
+
+    list_destroy(empty, NULL);
+    list_destroy(all, free_test_object);
+    list_destroy(rest, free_test_object);
+    list_destroy(tail, free_test_object);
+    list_destroy(list, free_test_object);
+}
+
+void test_list_splice(void) {
+    List *dst = list_create(LIST_LINKED_SENTINEL);
+    List *src = list_create(LIST_LINKED_SENTINEL);
+    for (int i = 0; i < 4; i++) {
+        list_append(dst, create_test_object(i, "dst"));
+    }
+    for (int i = 10; i < 13; i++) {
+        list_append(src, create_test_object(i, "src"));
+    }
+
+    // Middle: 0,1,10,11,12,2,3
+    TEST_ASSERT_TRUE(list_splice(dst, 2, src));
+    TEST_ASSERT_TRUE(list_is_empty(src));
+    TEST_ASSERT_EQUAL_UINT32(7, list_size(dst));
+    int expected[] = { 0, 1, 10, 11, 12, 2, 3 };
+    for (size_t i = 0; i < 7; i++) {
+        TEST_ASSERT_EQUAL_INT(expected[i], ((TestObject *)list_get(dst, i))->id);
+    }
+
+    // Front and back
+    list_append(src, create_test_object(20, "front"));
+    TEST_ASSERT_TRUE(list_splice(dst, 0, src));
+    list_append(src, create_test_object(30, "back"));
+    TEST_ASSERT_TRUE(list_splice(dst, list_size(dst), src));
+    TEST_ASSERT_EQUAL_INT(20, ((TestObject *)list_get(dst, 0))->id);
+    TEST_ASSERT_EQUAL_INT(30, ((TestObject *)list_get(dst, 8))->id);
+
+    // Splicing back what was split off restores the list
+    List *tail = list_split_at(dst, 4);
+    TEST_ASSERT_TRUE(list_splice(dst, 4, tail));
+    TEST_ASSERT_EQUAL_UINT32(9, list_size(dst));
+    TEST_ASSERT_EQUAL_INT(11, ((TestObject *)list_get(dst, 4))->id);
+
+    // Empty source, bad position, self splice
+    TEST_ASSERT_TRUE(list_splice(dst, 3, src));
+    TEST_ASSERT_FALSE(list_splice(dst, 10, tail));
+    TEST_ASSERT_FALSE(list_splice(dst, 0, dst));
+    TEST_ASSERT_FALSE(list_splice(NULL, 0, src));
+
+    list_destroy(tail, NULL);
+    list_destroy(src, NULL);
+    list_destroy(dst, free_test_object);
+}
+
+void test_list_append_insert_many(void) {
+    List *list = list_create(LIST_LINKED_SENTINEL);
+    TestObject *objs[8];
+    for (int i = 0; i < 8; i++) {
+        objs[i] = create_test_object(i, "bulk");
+    }
+
+    TEST_ASSERT_TRUE(list_append_many(list, (void **)objs, 3));
+    TEST_ASSERT_TRUE(list_append(list, objs[3]));
+    TEST_ASSERT_TRUE(list_append_many(list, (void **)&objs[6], 2));
+    TEST_ASSERT_TRUE(list_insert_many(list, 4, (void **)&objs[4], 2));
+    TEST_ASSERT_EQUAL_UINT32(8, list_size(list));
+    for (size_t i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL_PTR(objs[i], list_get(list, i));
+    }
+
+    // Removed nodes are reused and the list stays consistent
+    TestObject *r = list_remove(list, 5);
+    TEST_ASSERT_EQUAL_PTR(objs[5], r);
+    TEST_ASSERT_TRUE(list_insert(list, 0, r));
+    TEST_ASSERT_EQUAL_PTR(objs[5], list_get(list, 0));
+    TEST_ASSERT_EQUAL_PTR(objs[7], list_get(list, 7));
+
+    TEST_ASSERT_TRUE(list_insert_many(list, 0, NULL, 0));
+    TEST_ASSERT_FALSE(list_insert_many(list, 9, (void **)objs, 1));
+    TEST_ASSERT_FALSE(list_append_many(NULL, (void **)objs, 1));
+    TEST_ASSERT_FALSE(list_append_many(list, NULL, 2));
+    TEST_ASSERT_EQUAL_UINT32(8, list_size(list));
+
+    list_destroy(list, free_test_object);
+}
+
+void test_list_array_conversion(void) {
+    TestObject *objs[5];
+    for (int i = 0; i < 5; i++) {
+        objs[i] = create_test_object(i, "array");
+    }
+
+    List *list = list_from_array((void **)objs, 5);
+    TEST_ASSERT_NOT_NULL(list);
+    TEST_ASSERT_EQUAL_UINT32(5, list_size(list));
+
+    void *out[8] = { 0 };
+    TEST_ASSERT_EQUAL_UINT32(5, list_to_array(list, out, 8));
+    TEST_ASSERT_EQUAL_PTR_ARRAY(objs, out, 5);
+    TEST_ASSERT_NULL(out[5]);
+
+    // Capacity limits the copy
+    void *few[2];
+    TEST_ASSERT_EQUAL_UINT32(2, list_to_array(list, few, 2));
+    TEST_ASSERT_EQUAL_PTR(objs[1], few[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, list_to_array(NULL, few, 2));
+
+    // Round trip after modification
+    free_test_object(list_remove(list, 2));
+    TEST_ASSERT_EQUAL_UINT32(4, list_to_array(list, out, 8));
+    List *copy = list_from_array(out, 4);
+    TEST_ASSERT_EQUAL_PTR(objs[3], list_get(copy, 2));
+    list_destroy(copy, NULL);
+
+    List *empty = list_from_array(NULL, 0);
+    TEST_ASSERT_NOT_NULL(empty);
+    TEST_ASSERT_TRUE(list_is_empty(empty));
+    list_destroy(empty, NULL);
+
+    list_destroy(list, free_test_object);
+}
+
+void test_nodes_outlive_source_list(void) {
+    List *list = list_create(LIST_LINKED_SENTINEL);
+    void *items[100];
+    for (int i = 0; i < 100; i++) {
+        items[i] = create_test_object(i, "shared");
+    }
+    list_append_many(list, items, 100);
+
+    // The tail keeps living in the original block after its source is gone
+    List *tail = list_split_at(list, 60);
+    list_destroy(list, free_test_object);
+    TEST_ASSERT_EQUAL_INT(60, ((TestObject *)list_get(tail, 0))->id);
+
+    // Rotating by 10 for 50 rounds (500 mod 40 = 20) must not pile up state
+    for (int round = 0; round < 50; round++) {
+        List *part = list_split_at(tail, 10);
+        TEST_ASSERT_TRUE(list_splice(tail, 0, part));
+        list_destroy(part, NULL);
+    }
+    TEST_ASSERT_EQUAL_UINT32(40, list_size(tail));
+    TEST_ASSERT_EQUAL_INT(80, ((TestObject *)list_get(tail, 0))->id);
+    list_destroy(tail, free_test_object);
+}
+
 //P2
 void test_compare_int_and_sort(void) {
     List *list = list_create(LIST_LINKED_SENTINEL);
@@ -264,6 +458,1212 @@ void test_compare_str_and_sort(void) {
     list_destroy(list, free);
 }
 
+void test_sort_strategies_on_range(void) {
+    SortOptions bubble = { SORT_BUBBLE, 0, false };
+    SortOptions spill = { SORT_SPILL, 2, false };
+    SortOptions reuse = { SORT_SPILL, 2, true };
+    const SortOptions *options[] = { &bubble, &spill, &reuse, NULL };
+
+    for (size_t o = 0; o < 4; o++) {
+        srand(99);
+        List *list = create_random_int_list(300, 50);
+        TEST_ASSERT_TRUE(list_set_sort_options(list, options[o]));
+
+        void *before[300];
+        list_to_array(list, before, 300);
+
+        // Only [100, 249] is sorted, everything else stays where it was
+        sort(list, 100, 249, compare_int);
+        List *middle = list_split_at(list, 100);
+        List *after = list_split_at(middle, 150);
+        TEST_ASSERT_TRUE(is_sorted(middle, compare_int));
+        for (size_t i = 0; i < 100; i++) {
+            TEST_ASSERT_EQUAL_PTR(before[i], list_get(list, i));
+        }
+        for (size_t i = 0; i < 50; i++) {
+            TEST_ASSERT_EQUAL_PTR(before[250 + i], list_get(after, i));
+        }
+
+        // Sorting again (scratch reused when enabled) keeps it sorted
+        list_splice(list, 100, middle);
+        list_splice(list, 250, after);
+        sort(list, 0, 299, compare_int);
+        TEST_ASSERT_TRUE(is_sorted(list, compare_int));
+
+        list_destroy(after, NULL);
+        list_destroy(middle, NULL);
+        list_destroy(list, free);
+    }
+    TEST_ASSERT_FALSE(list_set_sort_options(NULL, NULL));
+}
+
+void test_spill_sort_large_inputs(void) {
+    srand(31337);
+    List *list = create_random_int_list(5000, 100000);
+    sort(list, 0, list_size(list) - 1, compare_int);
+    TEST_ASSERT_TRUE(is_sorted(list, compare_int));
+
+    // Already sorted, reversed and all-equal inputs
+    sort(list, 0, list_size(list) - 1, compare_int);
+    TEST_ASSERT_TRUE(is_sorted(list, compare_int));
+    int *vals = malloc(sizeof(int) * 2000);
+    List *reversed = list_create(LIST_LINKED_SENTINEL);
+    List *equal = list_create(LIST_LINKED_SENTINEL);
+    for (int i = 0; i < 1000; i++) {
+        vals[i] = i;
+        vals[1000 + i] = 7;
+        list_append(reversed, &vals[i]);
+        list_append(equal, &vals[1000 + i]);
+    }
+    sort(reversed, 0, 999, compare_int);
+    sort(equal, 0, 999, compare_int);
+    TEST_ASSERT_TRUE(is_sorted(reversed, compare_int));
+    TEST_ASSERT_EQUAL_INT(999, *(int *)list_get(reversed, 0));
+    TEST_ASSERT_TRUE(is_sorted(equal, compare_int));
+
+    list_destroy(equal, NULL);
+    list_destroy(reversed, NULL);
+    free(vals);
+    list_destroy(list, free);
+}
+
+typedef struct {
+    double weight;
+    int id;
+} WeightedItem;
+
+LIST_DEFINE_SORT(sort_weighted, WeightedItem, (a).weight < (b).weight)
+
+void test_generated_pdqsort(void) {
+    srand(8080);
+    size_t sizes[] = { 0, 1, 23, 24, 129, 3000 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t n = sizes[s];
+        WeightedItem *items = malloc(sizeof(WeightedItem) * (n ? n : 1));
+        for (size_t i = 0; i < n; i++) {
+            // Few distinct weights exercise the equal-key partition
+            items[i] = (WeightedItem){ (double)(rand() % 10) / 4.0, (int)i };
+        }
+        sort_weighted(items, n);
+        for (size_t i = 1; i < n; i++) {
+            TEST_ASSERT_TRUE(items[i - 1].weight <= items[i].weight);
+        }
+        free(items);
+    }
+
+    // Adversarial patterns: sorted, reversed, organ pipe
+    int *vals = malloc(sizeof(int) * 4000);
+    ListIntKey *keys = malloc(sizeof(ListIntKey) * 4000);
+    for (int pattern = 0; pattern < 3; pattern++) {
+        for (int i = 0; i < 4000; i++) {
+            vals[i] = pattern == 0 ? i : pattern == 1 ? 4000 - i : (i < 2000 ? i : 4000 - i);
+            keys[i] = (ListIntKey){ vals[i], &vals[i] };
+        }
+        list_sort_int_keys_desc(keys, 4000);
+        for (int i = 1; i < 4000; i++) {
+            TEST_ASSERT_TRUE(keys[i - 1].key >= keys[i].key);
+            TEST_ASSERT_EQUAL_INT(keys[i].key, *(int *)keys[i].data);
+        }
+    }
+    free(keys);
+    free(vals);
+
+    const char *strs[] = { "pear", "apple", "fig", "apple", "banana", "" };
+    list_sort_strs_asc(strs, 6);
+    TEST_ASSERT_EQUAL_STRING("", strs[0]);
+    TEST_ASSERT_EQUAL_STRING("apple", strs[2]);
+    TEST_ASSERT_EQUAL_STRING("pear", strs[5]);
+}
+
+void test_sort_specialized_paths(void) {
+    // compare_int takes the key path, compare_str the string path
+    srand(1212);
+    List *ints = create_random_int_list(2000, 1000000);
+    int *extremes = malloc(sizeof(int) * 2);
+    extremes[0] = INT_MIN;
+    extremes[1] = INT_MAX;
+    list_append(ints, &extremes[0]);
+    list_append(ints, &extremes[1]);
+    sort(ints, 0, list_size(ints) - 1, compare_int);
+    TEST_ASSERT_TRUE(is_sorted(ints, compare_int));
+    TEST_ASSERT_EQUAL_INT(INT_MAX, *(int *)list_get(ints, 0));
+    TEST_ASSERT_EQUAL_INT(INT_MIN, *(int *)list_get(ints, list_size(ints) - 1));
+    // Detach the extremes, they share one allocation
+    list_remove(ints, 0);
+    list_remove(ints, list_size(ints) - 1);
+    free(extremes);
+    list_destroy(ints, free);
+
+    List *strs = list_create(LIST_LINKED_SENTINEL);
+    for (int i = 0; i < 500; i++) {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "s%d", (i * 7919) % 500);
+        list_append(strs, strdup(buf));
+    }
+    sort(strs, 0, list_size(strs) - 1, compare_str);
+    TEST_ASSERT_TRUE(is_sorted(strs, compare_str));
+    list_destroy(strs, free);
+}
+
+void test_simd_int_sort_all_levels(void) {
+    ListSimdLevel levels[] = { LIST_SIMD_SCALAR, LIST_SIMD_SSE4, LIST_SIMD_AVX2 };
+    size_t sizes[] = { 0, 1, 7, 8, 16, 63, 64, 65, 200, 1000, 4099 };
+    int *keys = malloc(sizeof(int) * 4099);
+    int *expected = malloc(sizeof(int) * 4099);
+
+    for (size_t l = 0; l < 3; l++) {
+        ListSimdLevel prev = list_simd_limit(levels[l]);
+        srand(606);
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            size_t n = sizes[s];
+            for (size_t i = 0; i < n; i++) {
+                // Include the extremes so padding and ties are exercised
+                int r = rand();
+                keys[i] = i % 97 == 3 ? INT_MIN : i % 89 == 5 ? INT_MAX : r % 50 - 25;
+                expected[i] = keys[i];
+            }
+            TEST_ASSERT_TRUE(list_sort_ints_desc(keys, n));
+            for (size_t i = 1; i < n; i++) {
+                TEST_ASSERT_TRUE(keys[i - 1] >= keys[i]);
+            }
+            // Same multiset as the input: compare with the scalar pdqsort result
+            list_simd_limit(LIST_SIMD_SCALAR);
+            list_sort_ints_desc(expected, n);
+            list_simd_limit(levels[l]);
+            if (n > 0) {
+                TEST_ASSERT_EQUAL_INT_ARRAY(expected, keys, n);
+            }
+        }
+        list_simd_limit(prev);
+    }
+    free(expected);
+    free(keys);
+}
+
+void test_list_sort_int(void) {
+    srand(707);
+    List *list = create_random_int_list(500, 100000);
+    int *first = list_get(list, 0);
+    int before_first = *first;
+
+    // Sort only the tail; the head is untouched
+    TEST_ASSERT_TRUE(list_sort_int(list, 1, 499));
+    TEST_ASSERT_EQUAL_INT(before_first, *(int *)list_get(list, 0));
+    List *tail = list_split_at(list, 1);
+    TEST_ASSERT_TRUE(is_sorted(tail, compare_int));
+    list_splice(list, 1, tail);
+    list_destroy(tail, NULL);
+
+    TEST_ASSERT_TRUE(list_sort_int(list, 0, 499));
+    TEST_ASSERT_TRUE(is_sorted(list, compare_int));
+    TEST_ASSERT_TRUE(list_sort_int(list, 3, 3));
+    TEST_ASSERT_FALSE(list_sort_int(list, 0, 500));
+    TEST_ASSERT_FALSE(list_sort_int(NULL, 0, 1));
+    list_destroy(list, free);
+}
+
+void test_is_sorted_int_all_levels(void) {
+    ListSimdLevel levels[] = { LIST_SIMD_SCALAR, LIST_SIMD_SSE4, LIST_SIMD_AVX2 };
+    srand(808);
+    List *list = create_random_int_list(1000, 300);
+    list_sort_int(list, 0, 999);
+
+    // Positions around the 256-key batch boundaries and the vector tails
+    size_t spots[] = { 0, 7, 255, 256, 257, 512, 998 };
+    for (size_t l = 0; l < 3; l++) {
+        ListSimdLevel prev = list_simd_limit(levels[l]);
+        TEST_ASSERT_TRUE(list_is_sorted_int(list));
+        for (size_t s = 0; s < sizeof(spots) / sizeof(spots[0]); s++) {
+            int *val = list_get(list, spots[s] + 1);
+            int saved = *val;
+            *val = 1000;
+            TEST_ASSERT_FALSE(list_is_sorted_int(list));
+            TEST_ASSERT_EQUAL(is_sorted(list, compare_int), list_is_sorted_int(list));
+            *val = saved;
+        }
+        list_simd_limit(prev);
+    }
+
+    TEST_ASSERT_TRUE(list_is_sorted_int(NULL));
+    List *one = create_random_int_list(1, 10);
+    TEST_ASSERT_TRUE(list_is_sorted_int(one));
+    list_destroy(one, free);
+    list_destroy(list, free);
+}
+
+void test_top_k_and_partial_sort(void) {
+    srand(909);
+    List *list = create_random_int_list(1000, 500);
+    void *all[1000];
+    list_to_array(list, all, 1000);
+
+    // Reference: the fully sorted order of a copy
+    List *ref = list_from_array(all, 1000);
+    sort(ref, 0, 999, compare_int);
+
+    void *top[100];
+    TEST_ASSERT_EQUAL_UINT32(100, list_top_k(list, 100, compare_int, top));
+    for (size_t i = 0; i < 100; i++) {
+        TEST_ASSERT_EQUAL_INT(*(int *)list_get(ref, i), *(int *)top[i]);
+    }
+    // top_k leaves the list alone
+    TEST_ASSERT_EQUAL_PTR(all[0], list_get(list, 0));
+
+    TEST_ASSERT_TRUE(list_partial_sort(list, 100, compare_int));
+    TEST_ASSERT_EQUAL_UINT32(1000, list_size(list));
+    for (size_t i = 0; i < 100; i++) {
+        TEST_ASSERT_EQUAL_PTR(top[i], list_get(list, i));
+    }
+    // The other 900 elements keep their original relative order
+    size_t pos = 100;
+    for (size_t i = 0; i < 1000; i++) {
+        bool picked = false;
+        for (size_t j = 0; j < 100; j++) {
+            picked = picked || all[i] == top[j];
+        }
+        if (!picked) {
+            TEST_ASSERT_EQUAL_PTR(all[i], list_get(list, pos++));
+        }
+    }
+
+    // k larger than the list sorts everything
+    void *more[2000];
+    TEST_ASSERT_EQUAL_UINT32(1000, list_top_k(list, 2000, compare_int, more));
+    TEST_ASSERT_TRUE(list_partial_sort(list, 5000, compare_int));
+    TEST_ASSERT_TRUE(is_sorted(list, compare_int));
+
+    TEST_ASSERT_EQUAL_UINT32(0, list_top_k(list, 0, compare_int, top));
+    TEST_ASSERT_TRUE(list_partial_sort(list, 0, compare_int));
+    TEST_ASSERT_FALSE(list_partial_sort(NULL, 3, compare_int));
+
+    // Ties go to the earlier element, and equal ones keep list order
+    int v[5] = { 5, 5, 9, 5, 9 };
+    List *ties = list_create(LIST_LINKED_SENTINEL);
+    for (int i = 0; i < 5; i++) {
+        list_append(ties, &v[i]);
+    }
+    void *best[3];
+    TEST_ASSERT_EQUAL_UINT32(3, list_top_k(ties, 3, compare_int, best));
+    TEST_ASSERT_EQUAL_PTR(&v[2], best[0]);
+    TEST_ASSERT_EQUAL_PTR(&v[4], best[1]);
+    TEST_ASSERT_EQUAL_PTR(&v[0], best[2]);
+    TEST_ASSERT_EQUAL_UINT32(2, list_top_k(ties, 2, compare_int, best));
+    TEST_ASSERT_EQUAL_PTR(&v[2], best[0]);
+    TEST_ASSERT_EQUAL_PTR(&v[4], best[1]);
+    List *fives = list_create(LIST_LINKED_SENTINEL);
+    list_append(fives, &v[0]);
+    list_append(fives, &v[1]);
+    list_append(fives, &v[2]);
+    TEST_ASSERT_TRUE(list_partial_sort(fives, 2, compare_int));
+    TEST_ASSERT_EQUAL_PTR(&v[2], list_get(fives, 0));
+    TEST_ASSERT_EQUAL_PTR(&v[0], list_get(fives, 1));
+    TEST_ASSERT_EQUAL_PTR(&v[1], list_get(fives, 2));
+    list_destroy(fives, NULL);
+    list_destroy(ties, NULL);
+
+    list_destroy(ref, NULL);
+    list_destroy(list, free);
+}
+
+void test_select_and_quantiles(void) {
+    srand(1234);
+    List *list = create_random_int_list(2000, 300);
+    void *all[2000];
+    list_to_array(list, all, 2000);
+    List *ref = list_from_array(all, 2000);
+    sort(ref, 0, 1999, compare_int);
+
+    size_t ks[] = { 0, 1, 17, 999, 1000, 1998, 1999 };
+    for (size_t i = 0; i < sizeof(ks) / sizeof(ks[0]); i++) {
+        void *got = list_select(list, ks[i], compare_int);
+        TEST_ASSERT_NOT_NULL(got);
+        TEST_ASSERT_EQUAL_INT(*(int *)list_get(ref, ks[i]), *(int *)got);
+    }
+    TEST_ASSERT_NULL(list_select(list, 2000, compare_int));
+    // The list itself is untouched
+    TEST_ASSERT_EQUAL_PTR(all[0], list_get(list, 0));
+
+    double qs[] = { 0.99, 0.5, 0.0, 1.0, 0.25, 0.5, 1.7 };
+    void *out[7];
+    TEST_ASSERT_TRUE(list_quantiles(list, qs, 7, compare_int, out));
+    for (size_t i = 0; i < 7; i++) {
+        double q = qs[i] > 1.0 ? 1.0 : qs[i];
+        size_t rank = (size_t)(q * 1999);
+        TEST_ASSERT_EQUAL_INT(*(int *)list_get(ref, rank), *(int *)out[i]);
+    }
+
+    // A NaN quantile fails the whole call and leaves out alone
+    double with_nan[] = { 0.5, NAN };
+    out[0] = NULL;
+    TEST_ASSERT_FALSE(list_quantiles(list, with_nan, 2, compare_int, out));
+    TEST_ASSERT_NULL(out[0]);
+
+    List *empty = list_create(LIST_LINKED_SENTINEL);
+    TEST_ASSERT_NULL(list_select(empty, 0, compare_int));
+    TEST_ASSERT_FALSE(list_quantiles(empty, qs, 1, compare_int, out));
+
+    list_destroy(empty, NULL);
+    list_destroy(ref, NULL);
+    list_destroy(list, free);
+}
+
+// Context comparator: ints ordered by direction (+1 ascending, -1 descending)
+static int compare_int_dir(const void *a, const void *b, void *ctx) {
+    int ia = *(const int *)a;
+    int ib = *(const int *)b;
+    return ((ia > ib) - (ia < ib)) * *(const int *)ctx;
+}
+
+// Ints compared by their tens only, so many distinct elements tie
+static int compare_tens(const void *a, const void *b) {
+    int ia = *(const int *)a / 10;
+    int ib = *(const int *)b / 10;
+    return (ia < ib) - (ia > ib);
+}
+
+// Elements come from one array in list order, so ties must keep ascending addresses
+static void assert_stable(const List *list, CompareFunc cmp) {
+    ListIter it = list_iter(list);
+    void *prev;
+    void *cur;
+    TEST_ASSERT_TRUE(list_next(&it, &prev));
+    while (list_next(&it, &cur)) {
+        int r = cmp(prev, cur);
+        TEST_ASSERT_TRUE(r < 0 || (r == 0 && (char *)prev < (char *)cur));
+        prev = cur;
+    }
+}
+
+void test_sort_stable(void) {
+    enum { N = 600 };
+    static int vals[N];
+    static char strs[N][4];
+    srand(33);
+    for (int i = 0; i < N; i++) {
+        vals[i] = rand() % 50;
+        snprintf(strs[i], sizeof(strs[i]), "%d", rand() % 20);
+    }
+
+    ListType types[] = { LIST_LINKED_SENTINEL, LIST_COMPACT, LIST_XOR };
+    CompareFunc cmps[] = { compare_int, compare_tens, compare_str };
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        // Each sort starts from list order: inlined int and str paths, then a plain comparator
+        for (size_t c = 0; c < sizeof(cmps) / sizeof(cmps[0]); c++) {
+            List *list = list_create(types[t]);
+            for (int i = 0; i < N; i++) {
+                list_append(list, cmps[c] == compare_str ? (void *)strs[i] : (void *)&vals[i]);
+            }
+            sort(list, 0, N - 1, cmps[c]);
+            assert_stable(list, cmps[c]);
+            list_destroy(list, NULL);
+        }
+
+        // Context comparator path
+        List *list = list_create(types[t]);
+        for (int i = 0; i < N; i++) {
+            list_append(list, &vals[i]);
+        }
+        int down = -1;
+        sort_ctx(list, 0, N - 1, compare_int_dir, &down);
+        assert_stable(list, compare_int);
+        list_destroy(list, NULL);
+    }
+}
+
+void test_ctx_comparators(void) {
+    srand(77);
+    int up = 1;
+    int down = -1;
+
+    List *a = create_random_int_list(300, 1000);
+    List *b = create_random_int_list(10, 1000);
+    sort_ctx(a, 0, 299, compare_int_dir, &up);
+    sort_ctx(b, 0, 9, compare_int_dir, &up);
+    TEST_ASSERT_TRUE(is_sorted_ctx(a, compare_int_dir, &up));
+    TEST_ASSERT_TRUE(is_sorted_ctx(b, compare_int_dir, &up));
+    TEST_ASSERT_FALSE(is_sorted_ctx(a, compare_int_dir, &down));
+
+    List *m = merge_ctx(a, b, compare_int_dir, &up);
+    TEST_ASSERT_NOT_NULL(m);
+    TEST_ASSERT_EQUAL_UINT32(310, list_size(m));
+    TEST_ASSERT_TRUE(is_sorted_ctx(m, compare_int_dir, &up));
+
+    // Same comparator, other context: descending agrees with compare_int
+    sort_ctx(a, 0, 299, compare_int_dir, &down);
+    TEST_ASSERT_TRUE(is_sorted(a, compare_int));
+    sort_ctx(b, 0, 9, compare_int_dir, &down);
+    List *lists[] = { a, b };
+    List *k = list_merge_k_ctx(lists, 2, compare_int_dir, &down);
+    TEST_ASSERT_NOT_NULL(k);
+    TEST_ASSERT_EQUAL_UINT32(310, list_size(k));
+    TEST_ASSERT_TRUE(is_sorted(k, compare_int));
+
+    list_destroy(k, NULL);
+    list_destroy(m, NULL);
+    list_destroy(b, free);
+    list_destroy(a, free);
+}
+
+static int key_calls;
+
+// Key: the int value of a decimal string record, negated to test signed keys
+static void key_parse_neg(const void *elem, void *key) {
+    key_calls++;
+    int32_t k = -atoi((const char *)elem);
+    memcpy(key, &k, sizeof(k));
+}
+
+// Key: the first two characters of a string
+static void key_prefix2(const void *elem, void *key) {
+    key_calls++;
+    memcpy(key, elem, 2);
+}
+
+static int compare_prefix2(const void *a, const void *b) {
+    return memcmp(a, b, 2);
+}
+
+void test_sort_by_key(void) {
+    srand(4040);
+    List *list = list_create(LIST_LINKED_SENTINEL);
+    for (int i = 0; i < 500; i++) {
+        char *rec = malloc(16);
+        snprintf(rec, 16, "%d", rand() % 2001 - 1000);
+        list_append(list, rec);
+    }
+
+    // Radix path: one key call per element, result descending by value
+    key_calls = 0;
+    TEST_ASSERT_TRUE(list_sort_by_key(list, key_parse_neg, sizeof(int32_t), compare_key_i32));
+    TEST_ASSERT_EQUAL_INT(500, key_calls);
+    TEST_ASSERT_EQUAL_UINT32(500, list_size(list));
+    for (size_t i = 1; i < 500; i++) {
+        TEST_ASSERT_TRUE(atoi(list_get(list, i - 1)) >= atoi(list_get(list, i)));
+    }
+
+    // Comparison path is stable: equal prefixes keep the value order above
+    void *before[500];
+    list_to_array(list, before, 500);
+    key_calls = 0;
+    TEST_ASSERT_TRUE(list_sort_by_key(list, key_prefix2, 2, compare_prefix2));
+    TEST_ASSERT_EQUAL_INT(500, key_calls);
+    for (size_t i = 1; i < 500; i++) {
+        const char *x = list_get(list, i - 1);
+        const char *y = list_get(list, i);
+        int r = memcmp(x, y, 2);
+        TEST_ASSERT_TRUE(r <= 0);
+        if (r == 0) {
+            size_t px = 0;
+            size_t py = 0;
+            for (size_t j = 0; j < 500; j++) {
+                if (before[j] == x) px = j;
+                if (before[j] == y) py = j;
+            }
+            TEST_ASSERT_TRUE(px < py);
+        }
+    }
+
+    TEST_ASSERT_FALSE(list_sort_by_key(list, key_prefix2, 0, compare_prefix2));
+    TEST_ASSERT_FALSE(list_sort_by_key(NULL, key_prefix2, 2, compare_prefix2));
+    list_destroy(list, free);
+}
+
+void test_save_load(void) {
+    const char *path = "build/lab-test-save.bin";
+    srand(41);
+    List *ints = create_random_int_list(1000, 100000);
+    int *neg = malloc(sizeof(int));
+    *neg = INT_MIN;
+    list_append(ints, neg);
+    TEST_ASSERT_TRUE(list_save(ints, path, &LIST_CODEC_INT));
+
+    List *back = list_load(path, &LIST_CODEC_INT);
+    TEST_ASSERT_NOT_NULL(back);
+    TEST_ASSERT_EQUAL_UINT32(1001, list_size(back));
+    for (size_t i = 0; i < 1001; i++) {
+        TEST_ASSERT_EQUAL_INT(*(int *)list_get(ints, i), *(int *)list_get(back, i));
+    }
+    // Wrong codec for the file
+    TEST_ASSERT_NULL(list_load(path, &LIST_CODEC_STR));
+    list_destroy(back, free);
+    list_destroy(ints, free);
+
+    // Strings, including an empty one and one larger than the I/O buffer
+    List *strs = list_create(LIST_LINKED_SENTINEL);
+    list_append(strs, strdup("alpha"));
+    list_append(strs, strdup(""));
+    char *big = malloc((1 << 21) + 1);
+    memset(big, 'x', 1 << 21);
+    big[1 << 21] = '\0';
+    list_append(strs, big);
+    list_append(strs, strdup("omega"));
+    TEST_ASSERT_TRUE(list_save(strs, path, &LIST_CODEC_STR));
+
+    back = list_load(path, &LIST_CODEC_STR);
+    TEST_ASSERT_NOT_NULL(back);
+    TEST_ASSERT_EQUAL_UINT32(4, list_size(back));
+    for (size_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_STRING(list_get(strs, i), list_get(back, i));
+    }
+    list_destroy(back, free);
+
+    // A truncated file is rejected
+    TEST_ASSERT_EQUAL_INT(0, truncate(path, 40));
+    TEST_ASSERT_NULL(list_load(path, &LIST_CODEC_STR));
+    TEST_ASSERT_NULL(list_load("build/does-not-exist.bin", &LIST_CODEC_STR));
+
+    remove(path);
+    list_destroy(strs, free);
+}
+
+void test_iterator(void) {
+    List *list = list_create(LIST_LINKED_SENTINEL);
+    int vals[] = { 1, 2, 3, 4 };
+    for (int i = 0; i < 4; i++) {
+        list_append(list, &vals[i]);
+    }
+
+    ListIter it = list_iter(list);
+    void *elem;
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(list_next(&it, &elem));
+        TEST_ASSERT_EQUAL_PTR(&vals[i], elem);
+        TEST_ASSERT_EQUAL_UINT32(i, it.index);
+    }
+    TEST_ASSERT_FALSE(list_next(&it, &elem));
+    // Walking back from the ends starts at the last element
+    for (int i = 3; i >= 0; i--) {
+        TEST_ASSERT_TRUE(list_prev(&it, &elem));
+        TEST_ASSERT_EQUAL_PTR(&vals[i], elem);
+    }
+    TEST_ASSERT_FALSE(list_prev(&it, NULL));
+
+    List *empty = list_create(LIST_LINKED_SENTINEL);
+    it = list_iter(empty);
+    TEST_ASSERT_FALSE(list_next(&it, &elem));
+    TEST_ASSERT_FALSE(list_prev(&it, &elem));
+    it = list_iter(NULL);
+    TEST_ASSERT_FALSE(list_next(&it, &elem));
+
+    list_destroy(empty, NULL);
+    list_destroy(list, NULL);
+}
+
+void test_map_file(void) {
+    const char *path = "build/lab-test-map.bin";
+    srand(42);
+    List *ints = create_random_int_list(3000, 100000);
+    sort(ints, 0, 2999, compare_int);
+    TEST_ASSERT_TRUE(list_save(ints, path, &LIST_CODEC_INT));
+
+    List *mapped = list_map_file(path, &LIST_CODEC_INT);
+    TEST_ASSERT_NOT_NULL(mapped);
+    TEST_ASSERT_EQUAL_UINT32(3000, list_size(mapped));
+    TEST_ASSERT_FALSE(list_is_empty(mapped));
+    TEST_ASSERT_EQUAL_INT(*(int *)list_get(ints, 1234), *(int *)list_get(mapped, 1234));
+    TEST_ASSERT_NULL(list_get(mapped, 3000));
+    TEST_ASSERT_TRUE(is_sorted(mapped, compare_int));
+    TEST_ASSERT_TRUE(list_is_sorted_parallel(mapped, compare_int, 4));
+    TEST_ASSERT_TRUE(list_is_sorted_int(mapped));
+
+    // Backwards iteration over the mapping
+    ListIter it = list_iter(mapped);
+    void *elem;
+    size_t seen = 0;
+    while (list_prev(&it, &elem)) {
+        TEST_ASSERT_EQUAL_INT(*(int *)list_get(ints, 2999 - seen), *(int *)elem);
+        seen++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(3000, seen);
+
+    // Mapped lists are read-only but can feed merges
+    TEST_ASSERT_FALSE(list_append(mapped, NULL));
+    TEST_ASSERT_NULL(list_remove(mapped, 0));
+    TEST_ASSERT_NULL(list_split_at(mapped, 10));
+    List *other = create_random_int_list(500, 100000);
+    sort(other, 0, 499, compare_int);
+    List *m = merge(mapped, other, compare_int);
+    TEST_ASSERT_EQUAL_UINT32(3500, list_size(m));
+    TEST_ASSERT_TRUE(is_sorted(m, compare_int));
+    List *inputs[] = { other, mapped };
+    List *mk = list_merge_k(inputs, 2, compare_int);
+    TEST_ASSERT_EQUAL_UINT32(3500, list_size(mk));
+    TEST_ASSERT_TRUE(is_sorted(mk, compare_int));
+    list_destroy(mk, NULL);
+    list_destroy(m, NULL);
+    list_destroy(other, free);
+    list_destroy(mapped, free);
+    list_destroy(ints, free);
+
+    // Variable width elements are reached through the offset index
+    List *strs = list_create(LIST_LINKED_SENTINEL);
+    const char *words[] = { "pear", "", "apple", "a much longer string", "fig" };
+    for (int i = 0; i < 5; i++) {
+        list_append(strs, strdup(words[i]));
+    }
+    TEST_ASSERT_TRUE(list_save(strs, path, &LIST_CODEC_STR));
+    mapped = list_map_file(path, &LIST_CODEC_STR);
+    TEST_ASSERT_NOT_NULL(mapped);
+    for (size_t i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_STRING(words[i], list_get(mapped, i));
+    }
+    TEST_ASSERT_EQUAL_STRING("fig", list_get(mapped, 4));
+    TEST_ASSERT_NULL(list_map_file(path, &LIST_CODEC_INT));
+    // The indexed file still loads normally
+    List *loaded = list_load(path, &LIST_CODEC_STR);
+    TEST_ASSERT_EQUAL_UINT32(5, list_size(loaded));
+    TEST_ASSERT_EQUAL_STRING("a much longer string", list_get(loaded, 3));
+
+    list_destroy(loaded, free);
+    list_destroy(mapped, NULL);
+    list_destroy(strs, free);
+    remove(path);
+}
+
+void test_external_sort(void) {
+    const char *in = "build/lab-test-ext-in.bin";
+    const char *out = "build/lab-test-ext-out.bin";
+    // A tiny budget forces many runs and several merge passes
+    ExternalSortOptions opts = { 4096, "build" };
+
+    srand(43);
+    List *ints = create_random_int_list(20000, 1000000);
+    TEST_ASSERT_TRUE(list_save(ints, in, &LIST_CODEC_INT));
+    TEST_ASSERT_TRUE(list_external_sort(in, out, &LIST_CODEC_INT, compare_int, &opts));
+    List *sorted = list_load(out, &LIST_CODEC_INT);
+    TEST_ASSERT_NOT_NULL(sorted);
+    TEST_ASSERT_EQUAL_UINT32(20000, list_size(sorted));
+    TEST_ASSERT_TRUE(is_sorted(sorted, compare_int));
+    // Same multiset: compare against an in-memory sort
+    sort(ints, 0, 19999, compare_int);
+    for (size_t i = 0; i < 20000; i += 997) {
+        TEST_ASSERT_EQUAL_INT(*(int *)list_get(ints, i), *(int *)list_get(sorted, i));
+    }
+    list_destroy(sorted, free);
+    list_destroy(ints, free);
+
+    // Strings with the default budget end up in a mappable, indexed file
+    List *strs = list_create(LIST_LINKED_SENTINEL);
+    const char *words[] = { "kiwi", "apple", "", "mango", "banana", "apple" };
+    for (int i = 0; i < 6; i++) {
+        list_append(strs, strdup(words[i]));
+    }
+    TEST_ASSERT_TRUE(list_save(strs, in, &LIST_CODEC_STR));
+    opts.memory_budget = 0;
+    TEST_ASSERT_TRUE(list_external_sort(in, out, &LIST_CODEC_STR, compare_str, &opts));
+    List *mapped = list_map_file(out, &LIST_CODEC_STR);
+    TEST_ASSERT_NOT_NULL(mapped);
+    TEST_ASSERT_EQUAL_UINT32(6, list_size(mapped));
+    TEST_ASSERT_TRUE(is_sorted(mapped, compare_str));
+    TEST_ASSERT_EQUAL_STRING("", list_get(mapped, 0));
+    TEST_ASSERT_EQUAL_STRING("mango", list_get(mapped, 5));
+    list_destroy(mapped, NULL);
+
+    // Empty input still produces a valid empty output
+    List *empty = list_create(LIST_LINKED_SENTINEL);
+    TEST_ASSERT_TRUE(list_save(empty, in, &LIST_CODEC_STR));
+    TEST_ASSERT_TRUE(list_external_sort(in, out, &LIST_CODEC_STR, compare_str, NULL));
+    List *loaded = list_load(out, &LIST_CODEC_STR);
+    TEST_ASSERT_NOT_NULL(loaded);
+    TEST_ASSERT_EQUAL_UINT32(0, list_size(loaded));
+    TEST_ASSERT_FALSE(list_external_sort("build/does-not-exist.bin", out, &LIST_CODEC_STR,
+                                         compare_str, NULL));
+
+    list_destroy(loaded, NULL);
+    list_destroy(empty, NULL);
+    list_destroy(strs, free);
+    remove(in);
+    remove(out);
+}
+
+// Formats each element as an 'x' run as long as the element, for list_write
+static size_t format_run(const void *elem, char *out, size_t cap) {
+    size_t n = strlen((const char *)elem);
+    if (n <= cap) {
+        memset(out, 'x', n);
+    }
+    return n;
+}
+
+void test_list_write(void) {
+    const char *path = "build/lab-test-write.txt";
+    int vals[] = { 0, 7, -5, 42, 100, -1000, 123456789, INT_MAX, INT_MIN };
+    size_t nvals = sizeof(vals) / sizeof(vals[0]);
+    List *ints = list_create(LIST_LINKED_SENTINEL);
+    for (size_t i = 0; i < nvals; i++) {
+        list_append(ints, &vals[i]);
+    }
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    TEST_ASSERT_TRUE(list_write(ints, fd, list_format_int));
+    close(fd);
+    FILE *f = fopen(path, "r");
+    TEST_ASSERT_NOT_NULL(f);
+    char line[64];
+    for (size_t i = 0; i < nvals; i++) {
+        char expect[64];
+        snprintf(expect, sizeof(expect), "%d\n", vals[i]);
+        TEST_ASSERT_NOT_NULL(fgets(line, sizeof(line), f));
+        TEST_ASSERT_EQUAL_STRING(expect, line);
+    }
+    TEST_ASSERT_NULL(fgets(line, sizeof(line), f));
+    fclose(f);
+
+    // Many elements crossing buffer flushes, and one larger than the buffer
+    List *strs = list_create(LIST_LINKED_SENTINEL);
+    for (int i = 0; i < 100000; i++) {
+        list_append(strs, "abcdefghij");
+    }
+    char *big = malloc((1 << 21) + 1);
+    memset(big, 'y', 1 << 21);
+    big[1 << 21] = '\0';
+    list_append(strs, big);
+    list_append(strs, "");
+    list_append(strs, "end");
+
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    TEST_ASSERT_TRUE(list_write(strs, fd, list_format_str));
+    close(fd);
+    struct stat st;
+    TEST_ASSERT_EQUAL_INT(0, stat(path, &st));
+    TEST_ASSERT_EQUAL_INT64(100000 * 11 + (1 << 21) + 1 + 1 + 4, st.st_size);
+
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    TEST_ASSERT_TRUE(list_write(strs, fd, format_run));
+    close(fd);
+    TEST_ASSERT_EQUAL_INT(0, stat(path, &st));
+    TEST_ASSERT_EQUAL_INT64(100000 * 11 + (1 << 21) + 1 + 1 + 4, st.st_size);
+    f = fopen(path, "r");
+    TEST_ASSERT_NOT_NULL(f);
+    TEST_ASSERT_EQUAL_INT(0, fseek(f, -4, SEEK_END));
+    TEST_ASSERT_NOT_NULL(fgets(line, sizeof(line), f));
+    TEST_ASSERT_EQUAL_STRING("xxx\n", line);
+    fclose(f);
+
+    TEST_ASSERT_FALSE(list_write(ints, -1, list_format_int));
+    TEST_ASSERT_FALSE(list_write(NULL, STDOUT_FILENO, list_format_int));
+
+    free(big);
+    list_destroy(strs, NULL);
+    list_destroy(ints, NULL);
+    remove(path);
+}
+
+void test_string_arena(void) {
+    StringArena *arena = string_arena_create(false);
+    TEST_ASSERT_NOT_NULL(arena);
+
+    // Strings sharing long prefixes, short ones and the empty string
+    const char *words[] = { "", "a", "abcdefg", "abcdefgh", "abcdefgha", "abcdefghb",
+                            "abcdefgg", "abcdefghabcdefgh", "b", "zzzzzzzzzzzz", "\xff" };
+    size_t nwords = sizeof(words) / sizeof(words[0]);
+    const char *copies[sizeof(words) / sizeof(words[0])];
+    for (size_t i = 0; i < nwords; i++) {
+        copies[i] = string_arena_add(arena, words[i], strlen(words[i]));
+        TEST_ASSERT_NOT_NULL(copies[i]);
+        TEST_ASSERT_EQUAL_STRING(words[i], copies[i]);
+    }
+    for (size_t i = 0; i < nwords; i++) {
+        for (size_t j = 0; j < nwords; j++) {
+            int expect = strcmp(words[i], words[j]);
+            int got = compare_arena_str(copies[i], copies[j]);
+            TEST_ASSERT_EQUAL_INT((expect > 0) - (expect < 0), (got > 0) - (got < 0));
+        }
+    }
+
+    // Without interning every add is a separate copy
+    TEST_ASSERT_TRUE(string_arena_add(arena, "a", 1) != copies[1]);
+
+    // Enough strings for several chunks plus one larger than a chunk, sorted
+    srand(46);
+    List *list = list_create(LIST_LINKED_SENTINEL);
+    for (int i = 0; i < 100000; i++) {
+        char buf[24];
+        size_t len = (size_t)(rand() % 20);
+        for (size_t k = 0; k < len; k++) {
+            buf[k] = (char)('a' + rand() % 3);
+        }
+        list_append(list, (void *)string_arena_add(arena, buf, len));
+    }
+    char *big = malloc((1 << 21) + 1);
+    memset(big, 'q', 1 << 21);
+    list_append(list, (void *)string_arena_add(arena, big, 1 << 21));
+    free(big);
+    sort(list, 0, list_size(list) - 1, compare_arena_str);
+    TEST_ASSERT_TRUE(is_sorted(list, compare_str));
+    TEST_ASSERT_EQUAL_UINT32(1 << 21, strlen(list_get(list, list_size(list) - 1)));
+
+    // The list keeps the arena alive after the caller lets go of it
+    TEST_ASSERT_TRUE(list_attach_arena(list, arena));
+    TEST_ASSERT_FALSE(list_attach_arena(list, arena));
+    string_arena_release(arena);
+    TEST_ASSERT_EQUAL_STRING("", list_get(list, 0));
+    list_destroy(list, NULL);
+
+    // Interning returns the first copy of equal strings
+    arena = string_arena_create(true);
+    const char *first = string_arena_add(arena, "apple", 5);
+    TEST_ASSERT_TRUE(first == string_arena_add(arena, "apple!", 5));
+    TEST_ASSERT_TRUE(first != string_arena_add(arena, "apples", 6));
+    for (int i = 0; i < 5000; i++) {
+        char buf[16];
+        int len = snprintf(buf, sizeof(buf), "%d", i % 1000);
+        string_arena_add(arena, buf, (size_t)len);
+    }
+    TEST_ASSERT_TRUE(first == string_arena_add(arena, "apple", 5));
+    const char *seven = string_arena_add(arena, "7", 1);
+    TEST_ASSERT_TRUE(seven == string_arena_add(arena, "7", 1));
+    TEST_ASSERT_NULL(string_arena_add(NULL, "x", 1));
+    string_arena_release(arena);
+
+    // Every prefix of one string, so longer ones probe past their own prefixes
+    arena = string_arena_create(true);
+    char text[401];
+    const char *prefixes[400];
+    for (size_t len = 1; len <= 400; len++) {
+        text[len - 1] = (char)('a' + len % 26);
+        prefixes[len - 1] = string_arena_add(arena, text, len);
+        TEST_ASSERT_EQUAL_UINT32(len, strlen(prefixes[len - 1]));
+    }
+    for (size_t len = 1; len <= 400; len++) {
+        TEST_ASSERT_TRUE(prefixes[len - 1] == string_arena_add(arena, text, len));
+    }
+    string_arena_release(arena);
+}
+
+typedef struct {
+    int key;
+    int tag;
+    int check;
+} InlineRecord;
+
+static int compare_record(const void *a, const void *b) {
+    const InlineRecord *ra = (const InlineRecord *)a;
+    const InlineRecord *rb = (const InlineRecord *)b;
+    return (ra->key > rb->key) - (ra->key < rb->key);
+}
+
+void test_inline_values(void) {
+    TEST_ASSERT_NULL(list_create_inline(0));
+    TEST_ASSERT_NULL(list_create_inline(LIST_INLINE_MAX + 1));
+
+    // Values are copied, so one local can feed every append
+    srand(47);
+    List *ints = list_create_inline(sizeof(int));
+    int expect[500];
+    for (int i = 0; i < 500; i++) {
+        int v = rand() % 1000 - 500;
+        expect[i] = v;
+        TEST_ASSERT_TRUE(list_append(ints, &v));
+    }
+    TEST_ASSERT_FALSE(list_append(ints, NULL));
+    int front = 12345;
+    TEST_ASSERT_TRUE(list_insert(ints, 0, &front));
+    TEST_ASSERT_EQUAL_INT(12345, *(int *)list_get(ints, 0));
+    for (int i = 0; i < 500; i++) {
+        TEST_ASSERT_EQUAL_INT(expect[i], *(int *)list_get(ints, (size_t)i + 1));
+    }
+    TEST_ASSERT_EQUAL_INT(12345, *(int *)list_remove(ints, 0));
+
+    // Both sort strategies and the SIMD path move the values
+    List *copy = list_split_at(ints, 250);
+    TEST_ASSERT_EQUAL_UINT32(250, list_size(copy));
+    TEST_ASSERT_TRUE(list_append(copy, &front));
+    sort(ints, 0, list_size(ints) - 1, compare_int);
+    TEST_ASSERT_TRUE(is_sorted(ints, compare_int));
+    SortOptions bubble = { SORT_BUBBLE, 16, false };
+    TEST_ASSERT_TRUE(list_set_sort_options(copy, &bubble));
+    sort(copy, 0, list_size(copy) - 1, compare_int);
+    TEST_ASSERT_TRUE(is_sorted(copy, compare_int));
+    TEST_ASSERT_EQUAL_INT(12345, *(int *)list_get(copy, 0));
+
+    // Merged lists point into the inputs, which may be destroyed first
+    List *merged = merge(ints, copy, compare_int);
+    List *parts[3];
+    TEST_ASSERT_TRUE(list_partition(ints, 3, parts));
+    list_destroy(ints, free);
+    list_destroy(copy, free);
+    TEST_ASSERT_EQUAL_UINT32(501, list_size(merged));
+    TEST_ASSERT_TRUE(is_sorted(merged, compare_int));
+    TEST_ASSERT_TRUE(list_sort_int(parts[1], 0, list_size(parts[1]) - 1));
+    List *plain = list_create(LIST_LINKED_SENTINEL);
+    TEST_ASSERT_FALSE(list_splice(plain, 0, parts[0]));
+    TEST_ASSERT_TRUE(list_splice(parts[2], 0, parts[0]));
+    List *all = list_merge_k(parts, 3, compare_int);
+    for (int p = 0; p < 3; p++) {
+        list_destroy(parts[p], NULL);
+    }
+    TEST_ASSERT_EQUAL_UINT32(250, list_size(all));
+    list_destroy(all, NULL);
+    list_destroy(plain, NULL);
+    list_destroy(merged, NULL);
+
+    // Wider values keep their fields together through the generic sort path
+    List *recs = list_create_inline(sizeof(InlineRecord));
+    InlineRecord *batch[300];
+    for (int i = 0; i < 300; i++) {
+        batch[i] = malloc(sizeof(InlineRecord));
+        *batch[i] = (InlineRecord){ rand() % 50, i, 0 };
+        batch[i]->check = batch[i]->key * 1000 + i;
+    }
+    TEST_ASSERT_TRUE(list_append_many(recs, (void *const *)batch, 300));
+    for (int i = 0; i < 300; i++) {
+        free(batch[i]);
+    }
+    sort(recs, 0, 299, compare_record);
+    TEST_ASSERT_TRUE(is_sorted(recs, compare_record));
+    TEST_ASSERT_TRUE(list_sort_int(recs, 0, 299));
+    ListIter it = list_iter(recs);
+    void *elem;
+    while (list_next(&it, &elem)) {
+        const InlineRecord *r = elem;
+        TEST_ASSERT_EQUAL_INT(r->key * 1000 + r->tag, r->check);
+    }
+    list_destroy(recs, NULL);
+}
+
+LIST_DEFINE(intlist, int, (a) < (b))
+
+typedef struct {
+    double weight;
+    int id;
+} Weighted;
+
+LIST_DEFINE(weightlist, Weighted, (a).weight > (b).weight)
+
+void test_typed_list(void) {
+    intlist *l = intlist_create();
+    TEST_ASSERT_NOT_NULL(l);
+    TEST_ASSERT_TRUE(intlist_is_sorted(l));
+    TEST_ASSERT_TRUE(intlist_sort(l));
+
+    // 3 1 4 1 5 with 9 prepended and 2 inserted in the middle
+    int digits[] = { 3, 1, 4, 1, 5 };
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(intlist_append(l, digits[i]));
+    }
+    TEST_ASSERT_TRUE(intlist_prepend(l, 9));
+    TEST_ASSERT_TRUE(intlist_insert(l, 3, 2));
+    TEST_ASSERT_FALSE(intlist_insert(l, 8, 0));
+    int expect[] = { 9, 3, 1, 2, 4, 1, 5 };
+    for (size_t i = 0; i < 7; i++) {
+        TEST_ASSERT_EQUAL_INT(expect[i], *intlist_get(l, i));
+    }
+    TEST_ASSERT_NULL(intlist_get(l, 7));
+
+    int removed = 0;
+    TEST_ASSERT_TRUE(intlist_remove(l, 0, &removed));
+    TEST_ASSERT_EQUAL_INT(9, removed);
+    TEST_ASSERT_FALSE(intlist_remove(l, 6, NULL));
+    TEST_ASSERT_TRUE(intlist_sort(l));
+    TEST_ASSERT_TRUE(intlist_is_sorted(l));
+    int sorted[] = { 1, 1, 2, 3, 4, 5 };
+    size_t i = 0;
+    for (intlist_node *n = intlist_begin(l); n != intlist_end(l); n = n->next) {
+        TEST_ASSERT_EQUAL_INT(sorted[i++], n->value);
+    }
+    TEST_ASSERT_EQUAL_UINT32(6, intlist_size(l));
+
+    // Enough elements for several blocks, merged with the short list
+    srand(48);
+    intlist *big = intlist_create();
+    for (int k = 0; k < 100000; k++) {
+        TEST_ASSERT_TRUE(intlist_append(big, rand() % 1000 - 500));
+    }
+    TEST_ASSERT_FALSE(intlist_is_sorted(big));
+    TEST_ASSERT_TRUE(intlist_sort(big));
+    TEST_ASSERT_TRUE(intlist_is_sorted(big));
+    intlist *merged = intlist_merge(l, big);
+    TEST_ASSERT_EQUAL_UINT32(100006, intlist_size(merged));
+    TEST_ASSERT_TRUE(intlist_is_sorted(merged));
+    intlist_destroy(merged);
+    intlist_destroy(big);
+    intlist_destroy(l);
+
+    // Struct elements; merge keeps ties from the first list first
+    weightlist *wa = weightlist_create();
+    weightlist *wb = weightlist_create();
+    weightlist_append(wa, (Weighted){ 0.5, 1 });
+    weightlist_append(wa, (Weighted){ 2.0, 2 });
+    weightlist_append(wb, (Weighted){ 2.0, 4 });
+    weightlist_append(wb, (Weighted){ 1.0, 3 });
+    TEST_ASSERT_TRUE(weightlist_sort(wa));
+    weightlist *wm = weightlist_merge(wa, wb);
+    int ids[] = { 2, 4, 3, 1 };
+    for (size_t k = 0; k < 4; k++) {
+        TEST_ASSERT_EQUAL_INT(ids[k], weightlist_get(wm, k)->id);
+    }
+    weightlist_destroy(wm);
+    weightlist_destroy(wb);
+    weightlist_destroy(wa);
+}
+
+// Edits, iteration, sorting and merging on a list of type, checked against a linked list
+static void check_against_linked(ListType type, unsigned seed) {
+    List *list = list_create(type);
+    List *model = list_create(LIST_LINKED_SENTINEL);
+    TEST_ASSERT_NOT_NULL(list);
+
+    // Random edits mirrored on the model, with freed nodes reused
+    srand(seed);
+    for (int step = 0; step < 3000; step++) {
+        int op = rand() % 4;
+        if (op < 2 || list_size(model) == 0) {
+            int *val = malloc(sizeof(int));
+            *val = rand() % 100;
+            size_t at = (size_t)rand() % (list_size(model) + 1);
+            TEST_ASSERT_TRUE(list_insert(list, at, val));
+            TEST_ASSERT_TRUE(list_insert(model, at, val));
+        } else if (op == 2) {
+            size_t at = (size_t)rand() % list_size(model);
+            void *a = list_remove(list, at);
+            TEST_ASSERT_EQUAL_PTR(list_remove(model, at), a);
+            free(a);
+        } else {
+            int *val = malloc(sizeof(int));
+            *val = rand() % 100;
+            TEST_ASSERT_TRUE(list_append(list, val));
+            TEST_ASSERT_TRUE(list_append(model, val));
+        }
+    }
+    int *batch[3];
+    for (int i = 0; i < 3; i++) {
+        batch[i] = malloc(sizeof(int));
+        *batch[i] = i;
+    }
+    TEST_ASSERT_TRUE(list_insert_many(list, 1, (void *const *)batch, 3));
+    TEST_ASSERT_TRUE(list_insert_many(model, 1, (void *const *)batch, 3));
+    TEST_ASSERT_FALSE(list_insert(list, list_size(list) + 1, batch[0]));
+    TEST_ASSERT_NULL(list_remove(list, list_size(list)));
+
+    TEST_ASSERT_EQUAL_UINT32(list_size(model), list_size(list));
+    ListIter il = list_iter(list);
+    ListIter im = list_iter(model);
+    void *el;
+    void *em;
+    while (list_prev(&im, &em)) {
+        TEST_ASSERT_TRUE(list_prev(&il, &el));
+        TEST_ASSERT_EQUAL_PTR(em, el);
+    }
+    TEST_ASSERT_FALSE(list_prev(&il, &el));
+    TEST_ASSERT_EQUAL_PTR(list_get(model, 7), list_get(list, 7));
+
+    // Top-k reads through the iterator, ties included
+    void *best[20];
+    void *expect[20];
+    TEST_ASSERT_EQUAL_UINT32(20, list_top_k(list, 20, compare_int, best));
+    TEST_ASSERT_EQUAL_UINT32(20, list_top_k(model, 20, compare_int, expect));
+    TEST_ASSERT_EQUAL_PTR_ARRAY(expect, best, 20);
+
+    // Sorting through the public entry points
+    size_t n = list_size(list);
+    sort(list, 0, n / 2, compare_int);
+    sort_ctx(list, n / 2 + 1, n - 1, compare_int_dir, &(int){ -1 });
+    TEST_ASSERT_TRUE(list_sort_int(list, 0, n - 1));
+    TEST_ASSERT_TRUE(is_sorted(list, compare_int));
+    TEST_ASSERT_TRUE(list_is_sorted_int(list));
+
+    // Sort options apply as on linked lists
+    SortOptions bubble = { SORT_BUBBLE, 16, false };
+    SortOptions scratch = { SORT_SPILL, 2, true };
+    TEST_ASSERT_TRUE(list_set_sort_options(list, &bubble));
+    sort_ctx(list, 0, n - 1, compare_int_dir, &(int){ 1 });
+    TEST_ASSERT_TRUE(is_sorted_ctx(list, compare_int_dir, &(int){ 1 }));
+    TEST_ASSERT_TRUE(list_set_sort_options(list, &scratch));
+    sort(list, 0, n - 1, compare_int);
+    sort(list, 3, 20, compare_str);
+    sort(list, 3, 20, compare_int);
+    TEST_ASSERT_TRUE(is_sorted(list, compare_int));
+    TEST_ASSERT_TRUE(list_set_sort_options(list, NULL));
+
+    // Merging with a linked list gives a linked list
+    sort(model, 0, n - 1, compare_int);
+    List *merged = merge(list, model, compare_int);
+    TEST_ASSERT_EQUAL_UINT32(2 * n, list_size(merged));
+    TEST_ASSERT_TRUE(is_sorted(merged, compare_int));
+    List *tail = list_split_at(merged, 2 * n);
+    TEST_ASSERT_NOT_NULL(tail);
+    list_destroy(tail, NULL);
+    list_destroy(merged, NULL);
+
+    // Merging lists of this type only keeps the type
+    List *both[2] = { list, list };
+    merged = list_merge_k(both, 2, compare_int);
+    TEST_ASSERT_NULL(list_split_at(merged, 1));
+    TEST_ASSERT_TRUE(is_sorted(merged, compare_int));
+    list_destroy(merged, NULL);
+    merged = merge(list, list, compare_int);
+    TEST_ASSERT_EQUAL_UINT32(2 * n, list_size(merged));
+    TEST_ASSERT_NULL(list_split_at(merged, 1));
+    list_destroy(merged, NULL);
+    merged = list_merge_parallel(list, list, compare_int, 4);
+    TEST_ASSERT_EQUAL_UINT32(2 * n, list_size(merged));
+    TEST_ASSERT_NULL(list_split_at(merged, 1));
+    list_destroy(merged, NULL);
+    merged = list_merge_parallel(list, model, compare_int, 4);
+    TEST_ASSERT_TRUE(is_sorted(merged, compare_int));
+    tail = list_split_at(merged, 2 * n);
+    TEST_ASSERT_NOT_NULL(tail);
+    list_destroy(tail, NULL);
+    list_destroy(merged, NULL);
+
+    // Moving nodes between lists is not supported
+    List *parts[2];
+    TEST_ASSERT_NULL(list_split_at(list, 1));
+    TEST_ASSERT_FALSE(list_partition(list, 2, parts));
+    TEST_ASSERT_FALSE(list_splice(model, 0, list));
+    TEST_ASSERT_FALSE(list_partial_sort(list, 2, compare_int));
+
+    list_destroy(model, NULL);
+    list_destroy(list, free);
+}
+
+void test_compact_list(void) {
+    check_against_linked(LIST_COMPACT, 49);
+}
+
+void test_xor_list(void) {
+    check_against_linked(LIST_XOR, 50);
+    TEST_ASSERT_FALSE(list_next(&(ListIter){ 0 }, NULL));
+
+    // Prepends move the head, which XOR lists keep apart from the sentinel
+    List *xl = list_create(LIST_XOR);
+    List *model = list_create(LIST_LINKED_SENTINEL);
+    int values[64];
+    for (int i = 0; i < 64; i++) {
+        values[i] = i;
+        size_t at = i % 3 == 0 ? list_size(model) : 0;
+        TEST_ASSERT_TRUE(list_insert(xl, at, &values[i]));
+        TEST_ASSERT_TRUE(list_insert(model, at, &values[i]));
+        if (i % 5 == 4) {
+            TEST_ASSERT_EQUAL_PTR(list_remove(model, 0), list_remove(xl, 0));
+        }
+    }
+
+    // Both directions, turning around in the middle
+    TEST_ASSERT_EQUAL_UINT32(list_size(model), list_size(xl));
+    ListIter ix = list_iter(xl);
+    ListIter im = list_iter(model);
+    void *ex;
+    void *em;
+    while (list_next(&im, &em)) {
+        TEST_ASSERT_TRUE(list_next(&ix, &ex));
+        TEST_ASSERT_EQUAL_PTR(em, ex);
+    }
+    TEST_ASSERT_FALSE(list_next(&ix, &ex));
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(list_prev(&im, &em));
+        TEST_ASSERT_TRUE(list_prev(&ix, &ex));
+        TEST_ASSERT_EQUAL_PTR(em, ex);
+    }
+    TEST_ASSERT_TRUE(list_next(&ix, &ex));
+    TEST_ASSERT_TRUE(list_next(&im, &em));
+    TEST_ASSERT_EQUAL_PTR(em, ex);
+
+    list_destroy(model, NULL);
+    list_destroy(xl, NULL);
+}
+
 void test_merge_lists(void) {
     List *l1 = list_create(LIST_LINKED_SENTINEL);
     List *l2 = list_create(LIST_LINKED_SENTINEL);
@@ -387,6 +1787,186 @@ void test_randomized_merge(void) {
     list_destroy(merged, NULL); // merged shares data pointers
 }
 
+void test_merge_k_lists(void) {
+    srand(4242);
+    List *lists[5];
+    size_t sizes[] = { 40, 0, 1, 75, 33 };
+    size_t total = 0;
+    for (size_t i = 0; i < 5; i++) {
+        lists[i] = create_random_int_list(sizes[i], 50);
+        if (sizes[i] > 1) {
+            sort(lists[i], 0, sizes[i] - 1, compare_int);
+        }
+        total += sizes[i];
+    }
+
+    List *merged = list_merge_k(lists, 5, compare_int);
+    TEST_ASSERT_EQUAL_UINT32(total, list_size(merged));
+    TEST_ASSERT_TRUE(is_sorted(merged, compare_int));
+
+    // Two lists: same result as merge()
+    List *pair = list_merge_k(lists, 1, compare_int);
+    TEST_ASSERT_EQUAL_UINT32(40, list_size(pair));
+    list_destroy(pair, NULL);
+    List *expected = merge(lists[0], lists[3], compare_int);
+    List *both[] = { lists[0], lists[3] };
+    pair = list_merge_k(both, 2, compare_int);
+    for (size_t i = 0; i < list_size(expected); i++) {
+        TEST_ASSERT_EQUAL_PTR(list_get(expected, i), list_get(pair, i));
+    }
+    list_destroy(pair, NULL);
+    list_destroy(expected, NULL);
+
+    List *none = list_merge_k(lists, 0, compare_int);
+    TEST_ASSERT_TRUE(list_is_empty(none));
+    list_destroy(none, NULL);
+    TEST_ASSERT_NULL(list_merge_k(NULL, 2, compare_int));
+
+    list_destroy(merged, NULL);
+    for (size_t i = 0; i < 5; i++) {
+        list_destroy(lists[i], free);
+    }
+}
+
+void test_list_partition(void) {
+    List *list = list_create(LIST_LINKED_SENTINEL);
+    TestObject *objs[10];
+    for (int i = 0; i < 10; i++) {
+        objs[i] = create_test_object(i, "part");
+        list_append(list, objs[i]);
+    }
+
+    List *parts[4];
+    TEST_ASSERT_TRUE(list_partition(list, 4, parts));
+    TEST_ASSERT_TRUE(list_is_empty(list));
+
+    // Sizes 2,3,2,3 and the original order is preserved
+    size_t expected_sizes[] = { 2, 3, 2, 3 };
+    size_t next = 0;
+    for (size_t p = 0; p < 4; p++) {
+        TEST_ASSERT_EQUAL_UINT32(expected_sizes[p], list_size(parts[p]));
+        for (size_t i = 0; i < list_size(parts[p]); i++) {
+            TEST_ASSERT_EQUAL_PTR(objs[next++], list_get(parts[p], i));
+        }
+    }
+
+    // The parts are independent, working lists
+    TEST_ASSERT_TRUE(list_append(parts[0], create_test_object(99, "new")));
+    free_test_object(list_remove(parts[1], 1));
+    TEST_ASSERT_EQUAL_UINT32(3, list_size(parts[0]));
+
+    for (size_t p = 0; p < 4; p++) {
+        list_destroy(parts[p], free_test_object);
+    }
+
+    // More parts than elements leaves some empty
+    list_append(list, create_test_object(1, "one"));
+    List *many[3];
+    TEST_ASSERT_TRUE(list_partition(list, 3, many));
+    TEST_ASSERT_EQUAL_UINT32(0, list_size(many[0]));
+    TEST_ASSERT_EQUAL_UINT32(0, list_size(many[1]));
+    TEST_ASSERT_EQUAL_UINT32(1, list_size(many[2]));
+    for (size_t p = 0; p < 3; p++) {
+        list_destroy(many[p], free_test_object);
+    }
+
+    TEST_ASSERT_FALSE(list_partition(list, 0, many));
+    TEST_ASSERT_FALSE(list_partition(NULL, 2, many));
+    list_destroy(list, NULL);
+}
+
+// Parallel operations
+void test_merge_parallel_matches_merge(void) {
+    srand(2024);
+    // Few distinct values so the co-rank boundaries land inside runs of ties
+    List *l1 = create_random_int_list(337, 20);
+    List *l2 = create_random_int_list(512, 20);
+    sort(l1, 0, list_size(l1) - 1, compare_int);
+    sort(l2, 0, list_size(l2) - 1, compare_int);
+
+    List *expected = merge(l1, l2, compare_int);
+    size_t threads[] = { 1, 2, 3, 7, 16, 5000 };
+    for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+        List *merged = list_merge_parallel(l1, l2, compare_int, threads[t]);
+        TEST_ASSERT_NOT_NULL(merged);
+        TEST_ASSERT_EQUAL_UINT32(list_size(expected), list_size(merged));
+        TEST_ASSERT_TRUE(is_sorted(merged, compare_int));
+        for (size_t i = 0; i < list_size(expected); i++) {
+            // Same pointers in the same order, so ties keep merge()'s order
+            TEST_ASSERT_EQUAL_PTR(list_get(expected, i), list_get(merged, i));
+        }
+        list_destroy(merged, NULL);
+    }
+
+    list_destroy(expected, NULL);
+    list_destroy(l1, free);
+    list_destroy(l2, free);
+}
+
+void test_merge_parallel_edge_cases(void) {
+    List *empty = list_create(LIST_LINKED_SENTINEL);
+    List *one = create_random_int_list(1, 10);
+
+    List *merged = list_merge_parallel(empty, empty, compare_int, 4);
+    TEST_ASSERT_NOT_NULL(merged);
+    TEST_ASSERT_TRUE(list_is_empty(merged));
+    list_destroy(merged, NULL);
+
+    merged = list_merge_parallel(empty, one, compare_int, 4);
+    TEST_ASSERT_EQUAL_UINT32(1, list_size(merged));
+    TEST_ASSERT_EQUAL_PTR(list_get(one, 0), list_get(merged, 0));
+    list_destroy(merged, NULL);
+
+    TEST_ASSERT_NULL(list_merge_parallel(NULL, one, compare_int, 4));
+    TEST_ASSERT_NULL(list_merge_parallel(one, empty, NULL, 4));
+
+    list_destroy(empty, NULL);
+    list_destroy(one, free);
+}
+
+void test_destroy_parallel(void) {
+    size_t sizes[] = { 0, 1, 3, 1000 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        // Leaks or double frees are reported by the debug-test (ASan) build
+        list_destroy_parallel(create_random_int_list(sizes[s], 100), free, 4);
+    }
+    list_destroy_parallel(create_random_int_list(10, 100), free, 0);
+
+    List *list = list_create(LIST_LINKED_SENTINEL);
+    TestObject *obj = create_test_object(1, "kept");
+    list_append(list, obj);
+    list_destroy_parallel(list, NULL, 2);
+    TEST_ASSERT_EQUAL_INT(1, obj->id);
+    free_test_object(obj);
+
+    list_destroy_parallel(NULL, free, 2);
+}
+
+void test_is_sorted_parallel(void) {
+    srand(777);
+    List *list = create_random_int_list(1000, 1000);
+    sort(list, 0, list_size(list) - 1, compare_int);
+
+    size_t threads[] = { 0, 1, 2, 3, 8, 5000 };
+    for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+        TEST_ASSERT_TRUE(list_is_sorted_parallel(list, compare_int, threads[t]));
+    }
+
+    // Break the order on a segment boundary (500 with 2 threads) and at the end
+    int *mid = list_get(list, 500);
+    int saved = *mid;
+    *mid = 5000;
+    TEST_ASSERT_FALSE(list_is_sorted_parallel(list, compare_int, 2));
+    TEST_ASSERT_FALSE(list_is_sorted_parallel(list, compare_int, 7));
+    *mid = saved;
+
+    int *last = list_get(list, 999);
+    *last = 5000;
+    TEST_ASSERT_FALSE(list_is_sorted_parallel(list, compare_int, 4));
+
+    TEST_ASSERT_TRUE(list_is_sorted_parallel(NULL, compare_int, 4));
+    list_destroy(list, free);
+}
 
 /* === Test Runner === */
 int main(void) {
@@ -401,13 +1981,47 @@ int main(void) {
     RUN_TEST(test_list_create_invalid_type);
     RUN_TEST(test_list_destroy_null);
     RUN_TEST(test_list_get_null);
+    RUN_TEST(test_list_split_at);
+    RUN_TEST(test_list_splice);
+    RUN_TEST(test_list_append_insert_many);
+    RUN_TEST(test_list_array_conversion);
+    RUN_TEST(test_nodes_outlive_source_list);
     //P2
     RUN_TEST(test_compare_int_and_sort);
     RUN_TEST(test_compare_str_and_sort);
+    RUN_TEST(test_sort_strategies_on_range);
+    RUN_TEST(test_spill_sort_large_inputs);
+    RUN_TEST(test_generated_pdqsort);
+    RUN_TEST(test_sort_specialized_paths);
+    RUN_TEST(test_simd_int_sort_all_levels);
+    RUN_TEST(test_list_sort_int);
+    RUN_TEST(test_is_sorted_int_all_levels);
+    RUN_TEST(test_top_k_and_partial_sort);
+    RUN_TEST(test_select_and_quantiles);
+    RUN_TEST(test_ctx_comparators);
+    RUN_TEST(test_sort_stable);
+    RUN_TEST(test_sort_by_key);
+    RUN_TEST(test_save_load);
+    RUN_TEST(test_iterator);
+    RUN_TEST(test_map_file);
+    RUN_TEST(test_external_sort);
+    RUN_TEST(test_list_write);
+    RUN_TEST(test_string_arena);
+    RUN_TEST(test_inline_values);
+    RUN_TEST(test_typed_list);
+    RUN_TEST(test_compact_list);
+    RUN_TEST(test_xor_list);
     RUN_TEST(test_merge_lists);
     RUN_TEST(test_is_sorted_edge_cases);
     RUN_TEST(test_randomized_sort_and_is_sorted);
     RUN_TEST(test_randomized_merge);
+    RUN_TEST(test_merge_k_lists);
+    RUN_TEST(test_list_partition);
+    // Parallel operations
+    RUN_TEST(test_merge_parallel_matches_merge);
+    RUN_TEST(test_merge_parallel_edge_cases);
+    RUN_TEST(test_destroy_parallel);
+    RUN_TEST(test_is_sorted_parallel);
 
     return UNITY_END();
 }